@@ -10,9 +10,11 @@ from pandas import DataFrame, read_csv
 import matplotlib.pyplot as plt
 import pandas as pd #this is how I usually import pandas
 import sys #only needed to determine Python version number
+import os
 import matplotlib #only needed to determine Matplotlib version number
 import pdb
 import numpy as np
+from webResults import readResults
 
 SAVEFIGS = 1
 
@@ -37,6 +39,36 @@ def graphCDF(data, axs, label):
     axs.plot(ser_cdf.index[:], ser_cdf.iloc[:], label=label)
     return ser_cdf
 
+# Summary written by p4 --cdf=<name>.cdf.csv: rows kind,scope,x,y where kind is
+# cdf (x=response time, y=cumulative fraction) or percentile (x=quantile, y=value)
+# and scope is "all" or the client node index.
+cdfNames = ['kind', 'scope', 'x', 'y']
+
+def readCDF(csv, scope='all'):
+    df = read_csv(csv, names=cdfNames, dtype={'scope': str})
+    df = df[(df.kind == 'cdf') & (df.scope == scope)]
+    return pd.Series(df.y.values*100., index=df.x.values)
+
+def graphCDFFile(csv, axs, label):
+    # Use the precomputed CDF next to the raw samples when p4 wrote one,
+    # then the binary result file (p4 --out=<name>.wrb), then the raw csv.
+    base = csv[:-len('.csv')]
+    summary = base + '.cdf.csv'
+    if os.path.exists(summary):
+        ser_cdf = readCDF(summary)
+        axs.plot(ser_cdf.index[:], ser_cdf.iloc[:], label=label)
+        return ser_cdf
+    if os.path.exists(base + '.wrb'):
+        config, tables = readResults(base + '.wrb')
+        if 'responseTimes' in tables:
+            return graphCDF(tables['responseTimes'].responseTime, axs, label)
+        cdf = tables['cdf'][tables['cdf'].scope == -1]
+        ser_cdf = pd.Series(cdf.cumulative.values*100., index=cdf.responseTime.values)
+        axs.plot(ser_cdf.index[:], ser_cdf.iloc[:], label=label)
+        return ser_cdf
+    df = read_csv(csv, names=names)
+    return graphCDF(df.responseTime, axs, label)
+
 def plotREDSettings(settings, title, filename):
     for s in settings:
         l = s[0]
@@ -46,8 +78,7 @@ def plotREDSettings(settings, title, filename):
         maxTh = s[4]
         q = s[5]
         csv = 'p4/RED_load{}_queue{}_minTh{}_maxTh{}_wq{}_maxp{}.csv'.format(l, q, minTh, maxTh, wq, maxp)
-        df = read_csv(csv, names=names)
-        ser_cdf = graphCDF(df.responseTime, axs, label='RED - wq=1/{},maxp=1/{},th=({},{}), qlen={}'.format(wq, maxp, minTh, maxTh, q))
+        ser_cdf = graphCDFFile(csv, axs, label='RED - wq=1/{},maxp=1/{},th=({},{}), qlen={}'.format(wq, maxp, minTh, maxTh, q))
     axs.set_title(title)
     axs.set_xlabel('Response Times (ms)')
     axs.set_ylabel('Cumulative Probability (%)')
@@ -71,8 +102,7 @@ for l in loads:
     fig, axs = plt.subplots(1)
     for q in qlens:
         csv = 'p4/FIFO_load{}_queue{}.csv'.format(l, q)
-        df = read_csv(csv, names=names)
-        ser_cdf = graphCDF(df.responseTime, axs, label='qLen={}'.format(q))
+        ser_cdf = graphCDFFile(csv, axs, label='qLen={}'.format(q))
         #ser_cdf = graphCDF(pd.Series(np.random.normal(size=100)), axs, label=csv)
     axs.set_title('Figure 9{}. FIFO Performance at {}% Load'.format(titles.pop(0), l))
     axs.set_xlabel('Response Times (ms)')
@@ -91,8 +121,7 @@ fig, axs = plt.subplots(1)
 q = 120
 for l in loads:
     csv = 'p4/FIFO_load{}_queue{}.csv'.format(l, q)
-    df = read_csv(csv, names=names)
-    ser_cdf = graphCDF(df.responseTime, axs, label='load={}%'.format(l))
+    ser_cdf = graphCDFFile(csv, axs, label='load={}%'.format(l))
 axs.set_title('Figure 10. FIFO Performance at Different Loads (qLen=120)')
 axs.set_xlabel('Response Times (ms)')
 axs.set_ylabel('Cumulative Probability (%)')
@@ -111,8 +140,7 @@ maxTh=90
 q = 480
 for l in loads:
     csv = 'p4/RED_load{}_queue{}_minTh{}_maxTh{}_wq{}_maxp{}.csv'.format(l, q, minTh, maxTh, wq, maxp)
-    df = read_csv(csv, names=names)
-    ser_cdf = graphCDF(df.responseTime, axs, label='load={}%'.format(l))
+    ser_cdf = graphCDFFile(csv, axs, label='load={}%'.format(l))
 axs.set_title('Figure 11. RED Performance at Different Loads')
 axs.set_xlabel('Response Times (ms)')
 axs.set_ylabel('Cumulative Probability (%)')
@@ -137,8 +165,7 @@ for l in loads:
     fig, axs = plt.subplots(1)
     for minTh, maxTh in ths:
         csv = 'p4/RED_load{}_queue{}_minTh{}_maxTh{}_wq{}_maxp{}.csv'.format(l, q, minTh, maxTh, wq, maxp)
-        df = read_csv(csv, names=names)
-        ser_cdf = graphCDF(df.responseTime, axs, label='minTh={},maxTh={}'.format(minTh, maxTh))
+        ser_cdf = graphCDFFile(csv, axs, label='minTh={},maxTh={}'.format(minTh, maxTh))
     axs.set_title('Figure 12{}. RED Performance at {}% Load'.format(titles.pop(0), l))
     axs.set_xlabel('Response Times (ms)')
     axs.set_ylabel('Cumulative Probability (%)')
@@ -157,8 +184,7 @@ minThs = [5, 15, 30, 45, 60]
 fig, axs = plt.subplots(1)
 for minTh in minThs:
     csv = 'p4/RED_load{}_queue{}_minTh{}_maxTh{}_wq{}_maxp{}.csv'.format(l, q, minTh, maxTh, wq, maxp)
-    df = read_csv(csv, names=names)
-    ser_cdf = graphCDF(df.responseTime, axs, label='minTh={}'.format(minTh))
+    ser_cdf = graphCDFFile(csv, axs, label='minTh={}'.format(minTh))
 axs.set_title('Figure 13. RED Performance with Changing minTh')
 axs.set_xlabel('Response Times (ms)')
 axs.set_ylabel('Cumulative Probability (%)')
@@ -178,8 +204,7 @@ fig, axs = plt.subplots(1)
 for wq in wqs:
     for maxp in maxps:
         csv = 'p4/RED_load{}_queue{}_minTh{}_maxTh{}_wq{}_maxp{}.csv'.format(l, q, minTh, maxTh, wq, maxp)
-        df = read_csv(csv, names=names)
-        ser_cdf = graphCDF(df.responseTime, axs, label='wq=1/{},maxp=1/{}'.format(wq, maxp))
+        ser_cdf = graphCDFFile(csv, axs, label='wq=1/{},maxp=1/{}'.format(wq, maxp))
 axs.set_title('Figure 14. RED Performance with different wq and maxp')
 axs.set_xlabel('Response Times (ms)')
 axs.set_ylabel('Cumulative Probability (%)')
@@ -208,12 +233,10 @@ qlens = [120, 190]
 fig, axs = plt.subplots(1)
 # Uncongested
 csv = 'p4/FIFO_load{}_queue{}.csv'.format(10, 120)
-df = read_csv(csv, names=names)
-ser_cdf = graphCDF(df.responseTime, axs, label='uncongested')
+ser_cdf = graphCDFFile(csv, axs, label='uncongested')
 for q in qlens:
     csv = 'p4/FIFO_load{}_queue{}.csv'.format(l, q)
-    df = read_csv(csv, names=names)
-    ser_cdf = graphCDF(df.responseTime, axs, label='FIFO-qLen={}'.format(q))
+    ser_cdf = graphCDFFile(csv, axs, label='FIFO-qLen={}'.format(q))
 settings = [(90, 512, 10, 30, 90, 120),
         (90, 512, 10, 60, 180, 480)]
 plotREDSettings(settings, 'title', 'murgfilename')
@@ -231,12 +254,10 @@ qlens = [120, 190]
 fig, axs = plt.subplots(1)
 # Uncongested
 csv = 'p4/FIFO_load{}_queue{}.csv'.format(10, 120)
-df = read_csv(csv, names=names)
-ser_cdf = graphCDF(df.responseTime, axs, label='uncongested')
+ser_cdf = graphCDFFile(csv, axs, label='uncongested')
 for q in qlens:
     csv = 'p4/FIFO_load{}_queue{}.csv'.format(l, q)
-    df = read_csv(csv, names=names)
-    ser_cdf = graphCDF(df.responseTime, axs, label='FIFO-qLen={}'.format(q))
+    ser_cdf = graphCDFFile(csv, axs, label='FIFO-qLen={}'.format(q))
 settings = [(98, 512, 10, 30, 90, 120),
         (98, 128, 20, 5, 90, 480)]
 plotREDSettings(settings, 'title', 'murgfilename')
@@ -254,12 +275,10 @@ qlens = [120, 190]
 fig, axs = plt.subplots(1)
 # Uncongested
 csv = 'p4/FIFO_load{}_queue{}.csv'.format(10, 120)
-df = read_csv(csv, names=names)
-ser_cdf = graphCDF(df.responseTime, axs, label='uncongested')
+ser_cdf = graphCDFFile(csv, axs, label='uncongested')
 for q in qlens:
     csv = 'p4/FIFO_load{}_queue{}.csv'.format(l, q)
-    df = read_csv(csv, names=names)
-    ser_cdf = graphCDF(df.responseTime, axs, label='FIFO-qLen={}'.format(q))
+    ser_cdf = graphCDFFile(csv, axs, label='FIFO-qLen={}'.format(q))
 settings = [(110, 512, 10, 30, 90, 120),
         (110, 256, 20, 30, 90, 480)]
 plotREDSettings(settings, 'title', 'murgfilename')
@@ -0,0 +1,28 @@
+# Plots a bottleneck queue record written by p4 --queueTrace=<name>.wrb:
+# instantaneous and averaged queue length over time with the early and forced drops.
+# usage: python plotQueue.py <name>.wrb [<figure>.png]
+from __future__ import division
+
+import sys
+import matplotlib.pyplot as plt
+from webResults import readResults
+
+EARLY_DROP, FORCED_DROP = 2, 3
+
+config, tables = readResults(sys.argv[1])
+q = tables['queue']
+fig, axs = plt.subplots(1)
+axs.plot(q.time, q.bytes/1000., 'b-', label='queue length', drawstyle='steps-post')
+axs.plot(q.time, q.averageBytes/1000., 'k-', label='averaged queue length')
+for event, style, label in [(EARLY_DROP, 'g|', 'early drop'), (FORCED_DROP, 'rx', 'forced drop')]:
+    e = q[q.event == event]
+    if len(e):
+        axs.plot(e.time, e.bytes/1000., style, label=label)
+axs.set_title('Bottleneck Queue ({})'.format(config.get('queueType', '')))
+axs.set_xlabel('Time (s)')
+axs.set_ylabel('Queue Length (KB)')
+axs.legend(loc='upper right')
+if len(sys.argv) > 2:
+    plt.savefig(sys.argv[2])
+else:
+    plt.show()
@@ -0,0 +1,35 @@
+# Plots the browser-count ladder of p4 --profile (sweep/specs/p4Scale.spec): wall time per phase and
+# events per wall second against the number of browsers. Several profiles (e.g. one per commit) are
+# drawn side by side and the event rates are printed, so a slower hot path shows up as a lower line.
+# usage: python plotScaling.py <profile>.csv [<profile>.csv ...] [<figure>.png]
+from __future__ import division
+
+import os
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+PHASES = ['topologySeconds', 'routingSeconds', 'installSeconds', 'runSeconds', 'outputSeconds']
+
+files = [a for a in sys.argv[1:] if a.endswith('.csv')]
+figure = [a for a in sys.argv[1:] if not a.endswith('.csv')]
+fig, axs = plt.subplots(1, 2, figsize=(12, 5))
+for f in files:
+    p = pd.read_csv(f).sort_values('browsers')
+    label = os.path.basename(f)[:-4]
+    axs[0].loglog(p.browsers, p.wallSeconds, 'o-', label=label + ' total')
+    for phase in PHASES:
+        axs[0].loglog(p.browsers, p[phase], '.--', label='{} {}'.format(label, phase[:-7]))
+    axs[1].semilogx(p.browsers, p.eventsPerWallSecond, 'o-', label=label)
+    print(label)
+    print(p[['browsers', 'wallSeconds', 'simSecondsPerWallSecond', 'events', 'eventsPerWallSecond', 'peakRssKb']].to_string(index=False))
+axs[0].set_xlabel('Browsers')
+axs[0].set_ylabel('Wall Time (s)')
+axs[0].legend(loc='upper left', fontsize='small')
+axs[1].set_xlabel('Browsers')
+axs[1].set_ylabel('Events per Wall Second')
+axs[1].legend(loc='lower left')
+if figure:
+    plt.savefig(figure[0])
+else:
+    plt.show()
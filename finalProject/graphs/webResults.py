@@ -0,0 +1,97 @@
+# Reader for the columnar binary result files (.wrb) written by p4 --out
+# (format described in ns3Code/applications/model/WebResultFile.h).
+from __future__ import division
+
+import struct
+import numpy as np
+import pandas as pd
+
+MAGIC = b'NS3WEBR1'
+UINT64, INT64, DOUBLE, TIME = 0, 1, 2, 3
+
+def _u32(buf, pos):
+    return struct.unpack_from('<I', buf, pos)[0], pos + 4
+
+def _str(buf, pos):
+    n, pos = _u32(buf, pos)
+    return buf[pos:pos+n].decode('utf-8'), pos + n
+
+def _decodeVarints(data, rows):
+    b = np.frombuffer(data, dtype=np.uint8)
+    ends = np.nonzero(b < 0x80)[0]
+    if len(ends) != rows:
+        raise ValueError('corrupt column block')
+    starts = np.concatenate(([0], ends[:-1] + 1))
+    # position of every byte inside its varint
+    first = np.zeros(len(b), dtype=np.int64)
+    first[starts] = starts
+    first = np.maximum.accumulate(first)
+    shift = (7 * (np.arange(len(b)) - first)).astype(np.uint64)
+    parts = (b & 0x7f).astype(np.uint64) << shift
+    return np.add.reduceat(parts, starts)
+
+def _decodeColumn(ctype, data, rows):
+    if rows == 0:
+        return np.zeros(0, dtype=np.uint64)
+    v = _decodeVarints(data, rows)
+    if ctype == DOUBLE:
+        return np.bitwise_xor.accumulate(v)
+    delta = (v >> np.uint64(1)) ^ (np.uint64(0) - (v & np.uint64(1)))
+    return np.cumsum(delta, dtype=np.uint64)
+
+def _toSeries(ctype, raw):
+    if ctype == UINT64:
+        return raw
+    if ctype == INT64:
+        return raw.view(np.int64)
+    if ctype == TIME:
+        return raw.view(np.int64) / 1e9
+    return raw.view(np.float64)
+
+def readResults(path):
+    """Returns (config dict, {table name: DataFrame})."""
+    with open(path, 'rb') as f:
+        buf = f.read()
+    if buf[:len(MAGIC)] != MAGIC:
+        raise ValueError('{} is not a result file'.format(path))
+    pos = len(MAGIC)
+    config = {}
+    tables = {}
+    while pos < len(buf):
+        tag = buf[pos:pos+1]
+        pos += 1
+        if tag == b'E':
+            break
+        elif tag == b'C':
+            key, pos = _str(buf, pos)
+            value, pos = _str(buf, pos)
+            config[key] = value
+        elif tag == b'T':
+            tid, pos = _u32(buf, pos)
+            name, pos = _str(buf, pos)
+            n, pos = _u32(buf, pos)
+            cols = []
+            for i in range(n):
+                cname, pos = _str(buf, pos)
+                cols.append((cname, ord(buf[pos:pos+1])))
+                pos += 1
+            tables[tid] = (name, cols, [[] for c in cols])
+        elif tag == b'B':
+            tid, pos = _u32(buf, pos)
+            rows, pos = _u32(buf, pos)
+            name, cols, blocks = tables[tid]
+            for i, (cname, ctype) in enumerate(cols):
+                n, pos = _u32(buf, pos)
+                blocks[i].append(_decodeColumn(ctype, buf[pos:pos+n], rows))
+                pos += n
+        else:
+            raise ValueError('corrupt result file {}'.format(path))
+    frames = {}
+    for tid in tables:
+        name, cols, blocks = tables[tid]
+        data = {}
+        for i, (cname, ctype) in enumerate(cols):
+            raw = np.concatenate(blocks[i]) if blocks[i] else np.zeros(0, dtype=np.uint64)
+            data[cname] = _toSeries(ctype, raw)
+        frames[name] = pd.DataFrame(data, columns=[c[0] for c in cols])
+    return config, frames
@@ -20,6 +20,7 @@
 #include "tcpWebClientHelper.h"
 #include "ns3/uinteger.h"
 #include "ns3/names.h"
+#include "ns3/abort.h"
 #include "ns3/TcpWebClient.h"
 
 namespace ns3 {
@@ -80,6 +81,35 @@ TcpWebClientHelper::Install (NodeContainer c) const
   return apps;
 }
 
+int64_t
+TcpWebClientHelper::AssignStreams (NodeContainer c, int64_t stream, uint32_t maxClientsPerNode)
+{
+  uint32_t maxNodeId = 0;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<Node> node = (*i);
+      uint32_t browserIndex = 0;
+      for (uint32_t j = 0; j < node->GetNApplications (); j++)
+        {
+          Ptr<TcpWebClient> client = DynamicCast<TcpWebClient> (node->GetApplication (j));
+          if (client)
+            {
+              NS_ABORT_MSG_IF (browserIndex >= maxClientsPerNode,
+                               "Node " << node->GetId () << " holds more than "
+                               << maxClientsPerNode << " TcpWebClients");
+              int64_t slot = (int64_t)node->GetId () * maxClientsPerNode + browserIndex;
+              client->AssignStreams (stream + slot * TcpWebClient::STREAMS_PER_CLIENT);
+              browserIndex++;
+            }
+        }
+      if (node->GetId () > maxNodeId)
+        {
+          maxNodeId = node->GetId ();
+        }
+    }
+  return ((int64_t)maxNodeId + 1) * maxClientsPerNode * TcpWebClient::STREAMS_PER_CLIENT;
+}
+
 Ptr<Application>
 TcpWebClientHelper::InstallPriv (Ptr<Node> node) const
 {
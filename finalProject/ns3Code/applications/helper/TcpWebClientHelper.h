@@ -102,6 +102,23 @@ public:
    */
   ApplicationContainer Install (NodeContainer c) const;
 
+  /**
+   * Assign fixed random variable streams to the TcpWebClient applications
+   * already installed on the given nodes.
+   *
+   * The block of streams used by a client only depends on the id of its
+   * node and on its index among the TcpWebClients of that node (browser
+   * index), never on the order in which the helper visits the nodes.  The
+   * same population therefore draws the same traffic whether it is built
+   * in one process or split across several processes or MPI ranks.
+   *
+   * \param c the nodes holding the clients
+   * \param stream first stream index to use
+   * \param maxClientsPerNode number of browser slots reserved on every node
+   * \return the number of stream indices reserved (up to the highest node id in c)
+   */
+  int64_t AssignStreams (NodeContainer c, int64_t stream, uint32_t maxClientsPerNode);
+
 private:
   /**
    * Install an ns3::TcpWebClient on the node configured with all the
@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebQueueHelper.h"
+#include "ns3/abort.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+
+namespace ns3 {
+
+WebQueueHelper::WebQueueHelper ()
+{
+  m_factory.SetTypeId ("ns3::DropTailQueue");
+}
+
+std::string
+WebQueueHelper::ResolveName (std::string name)
+{
+  if (name == "droptail" || name == "fifo")
+    {
+      name = "ns3::DropTailQueue";
+    }
+  else if (name == "red")
+    {
+      name = "ns3::RedQueue";
+    }
+  else if (name == "codel")
+    {
+      name = "ns3::CoDelQueue";
+    }
+  else if (name == "ared" || name == "adaptive-red" || name == "fq_codel" || name == "fqcodel" || name == "pie")
+    {
+      NS_FATAL_ERROR ("queue " << name << " is not part of this ns-3 version (available: droptail, red, codel "
+                      "or a Queue TypeId name)");
+    }
+  TypeId tid;
+  NS_ABORT_MSG_IF (!TypeId::LookupByNameFailSafe (name, &tid), "unknown queue " << name);
+  NS_ABORT_MSG_IF (!tid.IsChildOf (Queue::GetTypeId ()), name << " is not a Queue");
+  return name;
+}
+
+void
+WebQueueHelper::SetQueue (std::string description)
+{
+  std::string::size_type colon = description.find (':');
+  m_factory = ObjectFactory ();
+  m_factory.SetTypeId (ResolveName (description.substr (0, colon)));
+  if (colon == std::string::npos)
+    {
+      return;
+    }
+  std::string attributes = description.substr (colon + 1);
+  std::string::size_type start = 0;
+  while (start < attributes.size ())
+    {
+      std::string::size_type end = attributes.find_first_of (", ", start);
+      if (end == std::string::npos)
+        {
+          end = attributes.size ();
+        }
+      std::string pair = attributes.substr (start, end - start);
+      start = end + 1;
+      if (pair.empty ())
+        {
+          continue;
+        }
+      std::string::size_type equal = pair.find ('=');
+      NS_ABORT_MSG_IF (equal == std::string::npos, "queue attribute " << pair << " is not key=value");
+      //the factory aborts on attributes the queue does not have
+      m_factory.Set (pair.substr (0, equal), StringValue (pair.substr (equal + 1)));
+    }
+}
+
+void
+WebQueueHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+Ptr<Queue>
+WebQueueHelper::Create (void) const
+{
+  return m_factory.Create<Queue> ();
+}
+
+void
+WebQueueHelper::Install (Ptr<NetDevice> device) const
+{
+  device->SetAttribute ("TxQueue", PointerValue (Create ()));
+}
+
+void
+WebQueueHelper::Install (NetDeviceContainer c) const
+{
+  for (NetDeviceContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Install (*i);
+    }
+}
+
+std::string
+WebQueueHelper::GetTypeName (void) const
+{
+  return m_factory.GetTypeId ().GetName ();
+}
+
+} // namespace ns3
@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef WEB_QUEUE_HELPER_H
+#define WEB_QUEUE_HELPER_H
+
+#include <string>
+#include "ns3/object-factory.h"
+#include "ns3/net-device-container.h"
+#include "ns3/queue.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ * \brief Builds a device transmit queue (AQM) from a text description
+ *
+ * The description is "name[:key=value,key=value...]" where name is an
+ * alias (droptail, red, codel) or any Queue TypeId name (ns3::...), and
+ * the pairs set attributes of that queue on top of its defaults, e.g.
+ * "red:MinTh=30,MaxTh=90,QW=0.002".  Install replaces the "TxQueue" of
+ * point to point devices, so a single link can get its own discipline.
+ */
+class WebQueueHelper
+{
+public:
+  WebQueueHelper ();
+
+  /**
+   * \param description queue name and attributes, aborts on unknown
+   *        or unavailable queues
+   */
+  void SetQueue (std::string description);
+
+  /**
+   * Record an attribute to be set on every queue created
+   *
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  Ptr<Queue> Create (void) const;
+
+  /**
+   * Give every device (with a "TxQueue" attribute) its own new queue
+   *
+   * \param c the devices
+   */
+  void Install (NetDeviceContainer c) const;
+  void Install (Ptr<NetDevice> device) const;
+
+  //TypeId name of the queues created
+  std::string GetTypeName (void) const;
+
+  /**
+   * \param name alias or TypeId name
+   * \return the TypeId name, aborts if the queue does not exist in this ns-3
+   */
+  static std::string ResolveName (std::string name);
+
+private:
+  ObjectFactory m_factory;
+};
+
+} // namespace ns3
+
+#endif /* WEB_QUEUE_HELPER_H */
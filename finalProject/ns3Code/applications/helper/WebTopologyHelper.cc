@@ -0,0 +1,393 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebTopologyHelper.h"
+#include "WebQueueHelper.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/queue.h"
+#include "ns3/ipv4.h"
+#include "ns3/mac48-address.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-channel.h"
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WebTopologyHelper");
+
+WebTopologyHelper::WebTopologyHelper ()
+  : m_base ("10.0.0.0"),
+    m_nLinks (0)
+{
+  m_queueFactory.SetTypeId ("ns3::DropTailQueue");
+  m_deviceFactory.SetTypeId ("ns3::PointToPointNetDevice");
+  m_channelFactory.SetTypeId ("ns3::PointToPointChannel");
+}
+
+void
+WebTopologyHelper::SetVariable (std::string name, std::string value)
+{
+  m_variables[name] = value;
+}
+
+void
+WebTopologyHelper::SetQueue (std::string type)
+{
+  m_queueFactory = ObjectFactory ();
+  m_queueFactory.SetTypeId (type);
+}
+
+void
+WebTopologyHelper::SetBase (Ipv4Address base)
+{
+  m_base = base;
+}
+
+void
+WebTopologyHelper::SetRoutingHelper (const Ipv4RoutingHelper &routing)
+{
+  m_stack.SetRoutingHelper (routing);
+}
+
+void
+WebTopologyHelper::Load (std::string fileName)
+{
+  std::ifstream in (fileName.c_str ());
+  NS_ABORT_MSG_IF (!in, "cannot open topology " << fileName);
+  Parse (in, fileName);
+}
+
+WebTopologyHelper::Endpoint
+WebTopologyHelper::ParseEndpoint (std::string word, std::string where) const
+{
+  Endpoint e;
+  e.index = -1;
+  std::string::size_type bracket = word.find ('[');
+  e.group = word.substr (0, bracket);
+  if (bracket != std::string::npos)
+    {
+      NS_ABORT_MSG_IF (word[word.size () - 1] != ']', where << ": bad node " << word);
+      e.index = std::atoi (word.substr (bracket + 1).c_str ());
+    }
+  bool declared = false;
+  for (uint32_t i = 0; i < m_groupSizes.size (); i++)
+    {
+      if (m_groupSizes[i].first == e.group)
+        {
+          declared = true;
+          NS_ABORT_MSG_IF (e.index >= (int32_t)m_groupSizes[i].second, where << ": " << word << " does not exist");
+        }
+    }
+  NS_ABORT_MSG_IF (!declared, where << ": no nodes " << e.group << " declared before");
+  return e;
+}
+
+void
+WebTopologyHelper::Parse (std::istream &in, std::string fileName)
+{
+  std::string line;
+  uint32_t lineNo = 0;
+  while (std::getline (in, line))
+    {
+      lineNo++;
+      std::ostringstream where;
+      where << fileName << ":" << lineNo;
+      std::string::size_type hash = line.find ('#');
+      if (hash != std::string::npos)
+        {
+          line = line.substr (0, hash);
+        }
+      std::istringstream words (line);
+      std::vector<std::string> w;
+      std::string word;
+      while (words >> word)
+        {
+          w.push_back (word);
+        }
+      if (w.empty ())
+        {
+          continue;
+        }
+      if (w[0] == "nodes" && (w.size () == 2 || w.size () == 3))
+        {
+          uint32_t count = w.size () == 3 ? std::atoi (w[2].c_str ()) : 1;
+          NS_ABORT_MSG_IF (count == 0, where.str () << ": empty group " << w[1]);
+          m_groupSizes.push_back (std::make_pair (w[1], count));
+        }
+      else if ((w[0] == "link" && w.size () >= 5) || (w[0] == "chain" && w.size () >= 4))
+        {
+          LinkStatement s;
+          s.chain = w[0] == "chain";
+          s.a = ParseEndpoint (w[1], where.str ());
+          uint32_t next = 2;
+          if (s.chain)
+            {
+              s.b = s.a;
+            }
+          else
+            {
+              s.b = ParseEndpoint (w[next++], where.str ());
+            }
+          std::string::size_type slash = w[next].find ('/');
+          s.rateAB = w[next].substr (0, slash);
+          s.rateBA = slash == std::string::npos ? s.rateAB : w[next].substr (slash + 1);
+          s.delay = w[next + 1];
+          s.where = where.str ();
+          for (uint32_t i = next + 2; i < w.size (); i++)
+            {
+              if (w[i].compare (0, 5, "name=") == 0)
+                {
+                  s.name = w[i].substr (5);
+                }
+              else if (w[i].compare (0, 6, "queue=") == 0)
+                {
+                  s.queue = w[i].substr (6);
+                }
+              else
+                {
+                  NS_FATAL_ERROR (where.str () << ": unknown link option " << w[i]);
+                }
+            }
+          m_links.push_back (s);
+        }
+      else if ((w[0] == "clients" || w[0] == "servers") && w.size () == 2)
+        {
+          ParseEndpoint (w[1], where.str ());
+          (w[0] == "clients" ? m_clientGroups : m_serverGroups).push_back (w[1]);
+        }
+      else
+        {
+          NS_FATAL_ERROR (where.str () << ": cannot parse '" << line << "'");
+        }
+    }
+}
+
+uint32_t
+WebTopologyHelper::GetNClientNodes (void) const
+{
+  uint32_t n = 0;
+  for (uint32_t c = 0; c < m_clientGroups.size (); c++)
+    {
+      for (uint32_t i = 0; i < m_groupSizes.size (); i++)
+        {
+          if (m_clientGroups[c] == m_groupSizes[i].first)
+            {
+              n += m_groupSizes[i].second;
+            }
+          else if (m_clientGroups[c].compare (0, m_groupSizes[i].first.size () + 1, m_groupSizes[i].first + "[") == 0)
+            {
+              n++;
+            }
+        }
+    }
+  return n;
+}
+
+std::string
+WebTopologyHelper::Substitute (std::string value, std::string where) const
+{
+  if (value.empty () || value[0] != '$')
+    {
+      return value;
+    }
+  std::map<std::string, std::string>::const_iterator it = m_variables.find (value.substr (1));
+  NS_ABORT_MSG_IF (it == m_variables.end (), where << ": " << value << " is not set");
+  return it->second;
+}
+
+std::vector<Ptr<Node> >
+WebTopologyHelper::Resolve (const Endpoint &e) const
+{
+  std::vector<Ptr<Node> > nodes;
+  const NodeContainer &group = m_groups.find (e.group)->second;
+  if (e.index >= 0)
+    {
+      nodes.push_back (group.Get (e.index));
+      return nodes;
+    }
+  for (uint32_t i = 0; i < group.GetN (); i++)
+    {
+      nodes.push_back (group.Get (i));
+    }
+  return nodes;
+}
+
+void
+WebTopologyHelper::Connect (Ptr<Node> a, Ptr<Node> b, const LinkStatement &s)
+{
+  Ptr<PointToPointNetDevice> devA = m_deviceFactory.Create<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = m_deviceFactory.Create<PointToPointNetDevice> ();
+  devA->SetAddress (Mac48Address::Allocate ());
+  devB->SetAddress (Mac48Address::Allocate ());
+  devA->SetDataRate (DataRate (Substitute (s.rateAB, s.where)));
+  devB->SetDataRate (DataRate (Substitute (s.rateBA, s.where)));
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  if (s.queue != "")
+    {
+      WebQueueHelper queue;
+      queue.SetQueue (s.queue);
+      devA->SetQueue (queue.Create ());
+      devB->SetQueue (queue.Create ());
+    }
+  else
+    {
+      devA->SetQueue (m_queueFactory.Create<Queue> ());
+      devB->SetQueue (m_queueFactory.Create<Queue> ());
+    }
+  Ptr<PointToPointChannel> channel = m_channelFactory.Create<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (Time (Substitute (s.delay, s.where))));
+  devA->Attach (channel);
+  devB->Attach (channel);
+
+  //link k gets base + 4k as its /30 subnet, .1 on the a side and .2 on the b side
+  uint32_t subnet = m_base.Get () + 4 * m_nLinks++;
+  Ptr<NetDevice> devices[2] = { devA, devB };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<Ipv4> ipv4 = devices[i]->GetNode ()->GetObject<Ipv4> ();
+      int32_t interface = ipv4->AddInterface (devices[i]);
+      ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (subnet + 1 + i), Ipv4Mask ("255.255.255.252")));
+      ipv4->SetMetric (interface, 1);
+      ipv4->SetUp (interface);
+    }
+  if (s.name != "")
+    {
+      m_named[s.name].Add (devA);
+      m_named[s.name].Add (devB);
+    }
+}
+
+void
+WebTopologyHelper::Build (void)
+{
+  for (uint32_t i = 0; i < m_groupSizes.size (); i++)
+    {
+      NodeContainer group;
+      group.Create (m_groupSizes[i].second);
+      m_groups[m_groupSizes[i].first] = group;
+      m_nodes.Add (group);
+    }
+  m_stack.Install (m_nodes);
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      const LinkStatement &s = m_links[l];
+      std::vector<Ptr<Node> > a = Resolve (s.a);
+      if (s.chain)
+        {
+          for (uint32_t i = 0; i + 1 < a.size (); i++)
+            {
+              Connect (a[i], a[i + 1], s);
+            }
+          continue;
+        }
+      std::vector<Ptr<Node> > b = Resolve (s.b);
+      if (a.size () == b.size ())
+        {
+          for (uint32_t i = 0; i < a.size (); i++)
+            {
+              Connect (a[i], b[i], s);
+            }
+        }
+      else if (a.size () > b.size ())
+        {
+          for (uint32_t i = 0; i < a.size (); i++)
+            {
+              Connect (a[i], b[i * b.size () / a.size ()], s);
+            }
+        }
+      else
+        {
+          for (uint32_t i = 0; i < b.size (); i++)
+            {
+              Connect (a[i * a.size () / b.size ()], b[i], s);
+            }
+        }
+    }
+  for (uint32_t c = 0; c < m_clientGroups.size (); c++)
+    {
+      std::vector<Ptr<Node> > nodes = Resolve (ParseEndpoint (m_clientGroups[c], "clients"));
+      for (uint32_t i = 0; i < nodes.size (); i++)
+        {
+          m_clients.Add (nodes[i]);
+        }
+    }
+  for (uint32_t c = 0; c < m_serverGroups.size (); c++)
+    {
+      std::vector<Ptr<Node> > nodes = Resolve (ParseEndpoint (m_serverGroups[c], "servers"));
+      for (uint32_t i = 0; i < nodes.size (); i++)
+        {
+          NS_ABORT_MSG_IF (nodes[i]->GetObject<Ipv4> ()->GetNInterfaces () < 2,
+                           "server " << m_serverGroups[c] << " has no link");
+          m_servers.Add (nodes[i]);
+        }
+    }
+  NS_LOG_INFO (m_nodes.GetN () << " nodes, " << m_nLinks << " links");
+}
+
+NodeContainer
+WebTopologyHelper::GetNodes (std::string group) const
+{
+  std::map<std::string, NodeContainer>::const_iterator it = m_groups.find (group);
+  NS_ABORT_MSG_IF (it == m_groups.end (), "no nodes " << group);
+  return it->second;
+}
+
+NodeContainer
+WebTopologyHelper::GetAllNodes (void) const
+{
+  return m_nodes;
+}
+
+NodeContainer
+WebTopologyHelper::GetClientNodes (void) const
+{
+  return m_clients;
+}
+
+NodeContainer
+WebTopologyHelper::GetServerNodes (void) const
+{
+  return m_servers;
+}
+
+NetDeviceContainer
+WebTopologyHelper::GetLinkDevices (std::string name) const
+{
+  std::map<std::string, NetDeviceContainer>::const_iterator it = m_named.find (name);
+  NS_ABORT_MSG_IF (it == m_named.end (), "no link named " << name);
+  return it->second;
+}
+
+Ipv4Address
+WebTopologyHelper::GetServerAddress (uint32_t server) const
+{
+  //interface 0 is the loopback
+  return m_servers.Get (server)->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ();
+}
+
+uint32_t
+WebTopologyHelper::GetNLinks (void) const
+{
+  return m_nLinks;
+}
+
+} // namespace ns3
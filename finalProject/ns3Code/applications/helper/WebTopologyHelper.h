@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef WEB_TOPOLOGY_HELPER_H
+#define WEB_TOPOLOGY_HELPER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <istream>
+#include "ns3/object-factory.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/internet-stack-helper.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ * \brief Builds a point to point topology of web clients and servers from
+ * a description file
+ *
+ * One statement per line, '#' starts a comment:
+ *
+ *   nodes core                    one node named core
+ *   nodes agg 2                   agg[0] and agg[1]
+ *   link core agg 1Gbps 2ms       a link from core to every agg node
+ *   link agg access 100Mbps/10Mbps 1ms
+ *                                 a/b gives the a->b and b->a rate of each link
+ *   chain router 10Mbps 5ms       router[0]-router[1]-... (parking lot)
+ *   link r[0] s[0] $bottleneckRate $linkDelays name=bottleneck queue=red:MinTh=45000
+ *   clients access                the browsers' nodes
+ *   servers web                   the web servers' nodes
+ *
+ * An endpoint is a group (all of its nodes) or one node group[i].  A single
+ * node is linked to every node of the other side; two groups are linked node
+ * by node when they have the same size, otherwise node i of the larger group
+ * goes to node i*small/large of the smaller one (a tree level).  $name is
+ * replaced by a value given with SetVariable.  queue= takes a WebQueueHelper
+ * description, other links get the queue set with SetQueue; name= labels the
+ * link(s) for GetLinkDevices.
+ *
+ * Build creates every node, installs the internet stack on all of them at
+ * once and wires the devices and channels directly, without a helper per
+ * link.  Link k gets the /30 subnet starting k*4 after the base address, so
+ * no address helper is needed either.
+ */
+class WebTopologyHelper
+{
+public:
+  WebTopologyHelper ();
+
+  /**
+   * Parse a description file, aborts with file:line on malformed statements
+   */
+  void Load (std::string fileName);
+  void Parse (std::istream &in, std::string fileName);
+
+  //value substituted for $name in rates and delays
+  void SetVariable (std::string name, std::string value);
+  //queue type of links without queue=
+  void SetQueue (std::string type);
+  //first address of the link subnets (default 10.0.0.0)
+  void SetBase (Ipv4Address base);
+  //routing of the internet stacks installed by Build (default static and global)
+  void SetRoutingHelper (const Ipv4RoutingHelper &routing);
+
+  //number of client nodes described, known before Build
+  uint32_t GetNClientNodes (void) const;
+
+  void Build (void);
+
+  NodeContainer GetNodes (std::string group) const;
+  NodeContainer GetAllNodes (void) const;
+  NodeContainer GetClientNodes (void) const;
+  NodeContainer GetServerNodes (void) const;
+  /**
+   * \return the devices of the links labelled name, a side then b side of
+   *         each link, so Get(1) transmits b->a on the first of them
+   */
+  NetDeviceContainer GetLinkDevices (std::string name) const;
+  //address of the first interface of a server node
+  Ipv4Address GetServerAddress (uint32_t server) const;
+  uint32_t GetNLinks (void) const;
+
+private:
+  typedef struct
+  {
+    std::string group;
+    int32_t index; //-1: every node of the group
+  } Endpoint;
+
+  typedef struct
+  {
+    Endpoint a;
+    Endpoint b;
+    bool chain;
+    std::string rateAB;
+    std::string rateBA;
+    std::string delay;
+    std::string name;
+    std::string queue;
+    std::string where; //file:line for errors found by Build
+  } LinkStatement;
+
+  Endpoint ParseEndpoint (std::string word, std::string where) const;
+  std::string Substitute (std::string value, std::string where) const;
+  std::vector<Ptr<Node> > Resolve (const Endpoint &e) const;
+  void Connect (Ptr<Node> a, Ptr<Node> b, const LinkStatement &s);
+
+  std::vector<std::pair<std::string, uint32_t> > m_groupSizes; //declared groups in order
+  std::vector<LinkStatement> m_links;
+  std::vector<std::string> m_clientGroups;
+  std::vector<std::string> m_serverGroups;
+  std::map<std::string, std::string> m_variables;
+  ObjectFactory m_queueFactory;
+  ObjectFactory m_deviceFactory;
+  ObjectFactory m_channelFactory;
+  Ipv4Address m_base;
+  InternetStackHelper m_stack;
+
+  std::map<std::string, NodeContainer> m_groups;
+  NodeContainer m_nodes;
+  NodeContainer m_clients;
+  NodeContainer m_servers;
+  std::map<std::string, NetDeviceContainer> m_named;
+  uint32_t m_nLinks;
+};
+
+} // namespace ns3
+
+#endif /* WEB_TOPOLOGY_HELPER_H */
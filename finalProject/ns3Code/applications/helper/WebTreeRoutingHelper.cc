@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebTreeRoutingHelper.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/channel.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include <map>
+#include <deque>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WebTreeRoutingHelper");
+
+namespace {
+
+//one end of a link as seen from a node
+typedef struct
+{
+  uint32_t interface; //of the node
+  uint32_t peer; //index of the neighbour
+  Ipv4Address peerAddress; //next hop
+  Ipv4Address network; //of the link
+  Ipv4Mask mask;
+} Neighbour;
+
+} // anonymous namespace
+
+uint32_t
+WebTreeRoutingHelper::Populate (NodeContainer nodes)
+{
+  //adjacency over the point to point links between the given nodes
+  std::map<uint32_t, uint32_t> indexOf; //node id -> index
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      indexOf[nodes.Get (i)->GetId ()] = i;
+    }
+  std::vector<std::vector<Neighbour> > links (nodes.GetN ());
+  uint32_t root = 0;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Node> node = nodes.Get (i);
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      NS_ABORT_MSG_IF (!ipv4, "node " << node->GetId () << " has no internet stack");
+      for (uint32_t d = 0; d < node->GetNDevices (); d++)
+        {
+          Ptr<NetDevice> device = node->GetDevice (d);
+          Ptr<Channel> channel = device->GetChannel ();
+          if (!channel || channel->GetNDevices () != 2)
+            {
+              continue;
+            }
+          Ptr<NetDevice> peerDevice = channel->GetDevice (channel->GetDevice (0) == device ? 1 : 0);
+          std::map<uint32_t, uint32_t>::const_iterator peer = indexOf.find (peerDevice->GetNode ()->GetId ());
+          int32_t interface = ipv4->GetInterfaceForDevice (device);
+          Ptr<Ipv4> peerIpv4 = peerDevice->GetNode ()->GetObject<Ipv4> ();
+          if (peer == indexOf.end () || interface < 0 || !peerIpv4)
+            {
+              continue;
+            }
+          Neighbour n;
+          n.interface = interface;
+          n.peer = peer->second;
+          n.peerAddress = peerIpv4->GetAddress (peerIpv4->GetInterfaceForDevice (peerDevice), 0).GetLocal ();
+          n.mask = ipv4->GetAddress (interface, 0).GetMask ();
+          n.network = ipv4->GetAddress (interface, 0).GetLocal ().CombineMask (n.mask);
+          links[i].push_back (n);
+        }
+      if (links[i].size () > links[root].size ())
+        {
+          root = i;
+        }
+    }
+
+  //breadth first from the root: parent link of every node, cycles and unreached nodes are fatal
+  std::vector<int32_t> parent (nodes.GetN (), -1); //index into links[node]
+  std::vector<bool> seen (nodes.GetN (), false);
+  std::vector<uint32_t> order;
+  std::deque<uint32_t> queue;
+  queue.push_back (root);
+  seen[root] = true;
+  while (!queue.empty ())
+    {
+      uint32_t v = queue.front ();
+      queue.pop_front ();
+      order.push_back (v);
+      for (uint32_t l = 0; l < links[v].size (); l++)
+        {
+          uint32_t c = links[v][l].peer;
+          if (parent[v] >= 0 && links[v][parent[v]].peer == c)
+            {
+              continue;
+            }
+          NS_ABORT_MSG_IF (seen[c], "the links have a cycle (node " << nodes.Get (c)->GetId ()
+                           << "), tree routing needs a tree");
+          seen[c] = true;
+          for (uint32_t back = 0; back < links[c].size (); back++)
+            {
+              if (links[c][back].peer == v)
+                {
+                  parent[c] = back;
+                }
+            }
+          queue.push_back (c);
+        }
+    }
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      NS_ABORT_MSG_IF (!seen[i], "node " << nodes.Get (i)->GetId () << " is not linked to the tree of node "
+                       << nodes.Get (root)->GetId () << ", tree routing needs every node connected");
+    }
+
+  //children before parents: the subnets below a node are those below its children plus their links
+  std::vector<std::vector<std::pair<Ipv4Address, Ipv4Mask> > > subnets (nodes.GetN ());
+  Ipv4StaticRoutingHelper staticRouting;
+  uint32_t routes = 0;
+  for (uint32_t k = order.size (); k-- > 0; )
+    {
+      uint32_t v = order[k];
+      Ptr<Ipv4StaticRouting> table = staticRouting.GetStaticRouting (nodes.Get (v)->GetObject<Ipv4> ());
+      for (uint32_t l = 0; l < links[v].size (); l++)
+        {
+          const Neighbour &n = links[v][l];
+          if ((int32_t)l == parent[v])
+            {
+              table->SetDefaultRoute (n.peerAddress, n.interface);
+              routes++;
+              continue;
+            }
+          //a child: everything below it goes through it
+          for (uint32_t s = 0; s < subnets[n.peer].size (); s++)
+            {
+              table->AddNetworkRouteTo (subnets[n.peer][s].first, subnets[n.peer][s].second, n.peerAddress, n.interface);
+              subnets[v].push_back (subnets[n.peer][s]);
+              routes++;
+            }
+          subnets[v].push_back (std::make_pair (n.network, n.mask));
+        }
+      //the children's lists are no longer needed
+      for (uint32_t l = 0; l < links[v].size (); l++)
+        {
+          if ((int32_t)l != parent[v])
+            {
+              std::vector<std::pair<Ipv4Address, Ipv4Mask> > ().swap (subnets[links[v][l].peer]);
+            }
+        }
+    }
+  NS_LOG_INFO (routes << " routes on " << nodes.GetN () << " nodes, root " << nodes.Get (root)->GetId ());
+  return routes;
+}
+
+} // namespace ns3
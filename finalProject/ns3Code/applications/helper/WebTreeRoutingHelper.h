@@ -0,0 +1,51 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef WEB_TREE_ROUTING_HELPER_H
+#define WEB_TREE_ROUTING_HELPER_H
+
+#include "ns3/node-container.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ * \brief Fills the static routing tables of a tree of point to point links
+ *
+ * Dumbbells, parking lots and access/aggregation/core trees have exactly
+ * one path between two nodes, so routes follow from the tree itself instead
+ * of the all pairs shortest paths of global routing.  The tree is rooted at
+ * the node with the most links; every other node gets a default route
+ * towards its parent and one network route per subnet below each of its
+ * children, leaves only the default route.  A node therefore holds as many
+ * routes as there are links below it, instead of one per destination.
+ *
+ * Populate aborts if the links of the nodes contain a cycle or do not
+ * connect every node.
+ */
+class WebTreeRoutingHelper
+{
+public:
+  /**
+   * \param nodes every node of the tree, with the internet stack installed
+   *        and the addresses assigned
+   * \return number of routes added
+   */
+  static uint32_t Populate (NodeContainer nodes);
+};
+
+} // namespace ns3
+
+#endif /* WEB_TREE_ROUTING_HELPER_H */
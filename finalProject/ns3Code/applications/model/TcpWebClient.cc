@@ -34,8 +34,16 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/http-distributions.h"
+#include "TcpWebCounters.h"
+#include "WebEventLog.h"
+#include "WebRequestHeader.h"
+#include "WebSocketPool.h"
+#include "WebObjectCatalog.h"
+#include "WebCompressionModel.h"
+#include "ns3/pointer.h"
 
 namespace ns3 {
 
@@ -44,6 +52,8 @@ NS_LOG_COMPONENT_DEFINE ("TcpWebClientApplication");
 
 NS_OBJECT_ENSURE_REGISTERED (TcpWebClient);
 
+const int64_t TcpWebClient::STREAMS_PER_CLIENT;
+
 //set NS3 attributes to allow access to have them set dynamically
 //also sets default values
 TypeId
@@ -66,9 +76,27 @@ TcpWebClient::GetTypeId (void)
 	.AddAttribute("MaxConcurrentSockets","Maximum Number of Concurrent Sockets",
 				  UintegerValue(4),MakeUintegerAccessor(&TcpWebClient::m_maxConncurrentSockets),
 				  MakeUintegerChecker<uint32_t>())
+	.AddAttribute("Catalog","Objects of the server the secondary requests ask for, by Zipf popularity and with "
+				  "their fixed sizes, in the request header (none: sizes drawn per request, no object ids)",
+				  PointerValue(),MakePointerAccessor(&TcpWebClient::m_catalog),
+				  MakePointerChecker<WebObjectCatalog>())
+	.AddAttribute("Compression","Compression model of the server: requests carry the content type of their "
+				  "response and the compressed size is expected (none: responses as asked for)",
+				  PointerValue(),MakePointerAccessor(&TcpWebClient::m_compression),
+				  MakePointerChecker<WebCompressionModel>())
+	.AddAttribute("StoreResponseTimes","Keep every page in the vector returned by getResponseTimes "
+				  "(false when only the PageComplete trace is used)",
+				  BooleanValue(true),MakeBooleanAccessor(&TcpWebClient::m_storeResponseTimes),
+				  MakeBooleanChecker())
     .AddTraceSource ("Tx", "A new packet is created and is sent",
                      MakeTraceSourceAccessor (&TcpWebClient::m_txTrace),
                      "ns3::Packet::TracedCallback")
+    .AddTraceSource ("PageComplete", "All objects of a page have been received",
+                     MakeTraceSourceAccessor (&TcpWebClient::m_pageCompleteTrace),
+                     "ns3::TcpWebClient::PageCompleteTracedCallback")
+    .AddTraceSource ("ObjectComplete", "The whole response of one connection has been received",
+                     MakeTraceSourceAccessor (&TcpWebClient::m_objectCompleteTrace),
+                     "ns3::TcpWebClient::ObjectCompleteTracedCallback")
   ;
   return tid;
 }
@@ -84,6 +112,7 @@ void TcpWebClient::InitializeModelDistributions(){
 	  primaryResponseSizeGenerator= CreateObject<EmpiricalRandomVariable> ();
 	  secondaryResponseSizeGenerator= CreateObject<EmpiricalRandomVariable> ();
 	  totalPagesToFetchGenerator= CreateObject<EmpiricalRandomVariable> ();
+	  objectGenerator= CreateObject<UniformRandomVariable> ();
 	for(uint32_t i=0; i<sizeof(httpDist::consecutivePages)/sizeof(httpDist::intd_t);i++){
 		totalPagesToFetchGenerator->CDF(httpDist::consecutivePages[i].i,httpDist::consecutivePages[i].d);
 	}
@@ -105,9 +134,25 @@ void TcpWebClient::InitializeModelDistributions(){
 	for(uint32_t i=0; i<sizeof(httpDist::filesPerPage)/sizeof(httpDist::intd_t);i++){
 		numFilesToFetchGenerator->CDF(httpDist::filesPerPage[i].i,httpDist::filesPerPage[i].d);
 	}
-	//get number of pages to be fetched by this browser instance by sampling CDF
-	m_totalPagesToFetch=(uint32_t)totalPagesToFetchGenerator->GetValue();
-	//NS_LOG_FUNCTION("TOTAL PAGES: " << m_totalPagesToFetch);
+}
+
+/**
+ * AssignStreams- pins every model distribution to its own stream so the session
+ * only depends on the stream index handed in (not on construction order)
+ */
+int64_t
+TcpWebClient::AssignStreams (int64_t stream)
+{
+  TCPWEB_LOG_FUNCTION (this << stream);
+  totalPagesToFetchGenerator->SetStream (stream);
+  thinkTimeGenerator->SetStream (stream + 1);
+  primaryRequestSizeGenerator->SetStream (stream + 2);
+  secondaryRequestSizeGenerator->SetStream (stream + 3);
+  primaryResponseSizeGenerator->SetStream (stream + 4);
+  secondaryResponseSizeGenerator->SetStream (stream + 5);
+  numFilesToFetchGenerator->SetStream (stream + 6);
+  objectGenerator->SetStream (stream + 7);
+  return STREAMS_PER_CLIENT;
 }
 
 /**
@@ -116,6 +161,8 @@ void TcpWebClient::InitializeModelDistributions(){
 TcpWebClient::TcpWebClient ()
 {
   m_sent = 0;
+  m_totalPagesToFetch = 0;
+  m_storeResponseTimes = true;
   m_sendEvent = EventId ();
   InitializeModelDistributions();
 }
@@ -127,7 +174,7 @@ TcpWebClient::~TcpWebClient()
 void 
 TcpWebClient::SetRemote (Address ip, uint16_t port)
 {
-  NS_LOG_FUNCTION (this << ip << port);
+  TCPWEB_LOG_FUNCTION (this << ip << port);
   m_peerAddress = ip;
   m_peerPort = port;
 }
@@ -135,7 +182,7 @@ TcpWebClient::SetRemote (Address ip, uint16_t port)
 void 
 TcpWebClient::SetRemote (Ipv4Address ip, uint16_t port)
 {
-  NS_LOG_FUNCTION (this << ip << port);
+  TCPWEB_LOG_FUNCTION (this << ip << port);
   m_peerAddress = Address (ip);
   m_peerPort = port;
 }
@@ -143,7 +190,7 @@ TcpWebClient::SetRemote (Ipv4Address ip, uint16_t port)
 void 
 TcpWebClient::SetRemote (Ipv6Address ip, uint16_t port)
 {
-  NS_LOG_FUNCTION (this << ip << port);
+  TCPWEB_LOG_FUNCTION (this << ip << port);
   m_peerAddress = Address (ip);
   m_peerPort = port;
 }
@@ -152,7 +199,10 @@ TcpWebClient::SetRemote (Ipv6Address ip, uint16_t port)
 void
 TcpWebClient::DoDispose (void)
 {
-  NS_LOG_FUNCTION (this);
+  TCPWEB_LOG_FUNCTION (this);
+  m_socketPool = 0;
+  m_catalog = 0;
+  m_compression = 0;
   Application::DoDispose ();
 }
 
@@ -160,30 +210,38 @@ TcpWebClient::DoDispose (void)
 void 
 TcpWebClient::StartApplication (void)
 {
-  NS_LOG_FUNCTION (this);
+  TCPWEB_LOG_FUNCTION (this);
+  //get number of pages to be fetched by this browser instance by sampling CDF
+  //(done here rather than in the constructor so AssignStreams can take effect first)
+  m_totalPagesToFetch=(uint32_t)totalPagesToFetchGenerator->GetValue();
+  m_socketPool=WebSocketPool::Get(GetNode());
+  //NS_LOG_FUNCTION("TOTAL PAGES: " << m_totalPagesToFetch);
   StartNewServerConnection(true);
 }
 
 //callback for when TCP connection successfully closed
 void 
 TcpWebClient::HandleSuccessfulClose(Ptr<Socket> socket){
-	NS_LOG_FUNCTION (this);
+	TCPWEB_LOG_FUNCTION (this);
+	TCPWEB_COUNT(CLIENT,CALLBACKS,1);
 }
 
 //callback for when error occurs when closing TCP connection
 void
 TcpWebClient::HandleErrorClose(Ptr<Socket> socket){
-	NS_LOG_FUNCTION (this);
+	TCPWEB_LOG_FUNCTION (this);
+	TCPWEB_COUNT(CLIENT,CALLBACKS,1);
 }
 
 //Stops application and ensures all resources are cleared
 void
 TcpWebClient::StopApplication ()
 {
-  NS_LOG_FUNCTION (this);
+  TCPWEB_LOG_FUNCTION (this);
   //Close every socket and make sure the receive callbacks are null
   for(uint32_t i=0;i<m_primarySockets.size();i++){
 	  m_primarySockets[i]->Close();
+	  TCPWEB_COUNT(CLIENT,SOCKETS_CLOSED,1);
 	  m_primarySockets[i]->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
 	  m_primarySockets[i]=0;
   }
@@ -191,6 +249,7 @@ TcpWebClient::StopApplication ()
   //Do the same for the secondary sockets
   for(uint32_t i=0;i<m_secondarySockets.size();i++){
 	  m_secondarySockets[i]->Close();
+	  TCPWEB_COUNT(CLIENT,SOCKETS_CLOSED,1);
 	  m_secondarySockets[i]->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
 	  m_secondarySockets[i]=0;
   }
@@ -203,9 +262,9 @@ TcpWebClient::StopApplication ()
 void 
 TcpWebClient::ScheduleTransmit (Time dt)
 {
-  NS_LOG_FUNCTION (this << dt);
-  NS_LOG_FUNCTION("PRIMARY: " << m_primarySockets.size());
-  NS_LOG_FUNCTION("Secondary: " << m_secondarySockets.size());
+  TCPWEB_LOG_FUNCTION (this << dt);
+  TCPWEB_LOG_FUNCTION("PRIMARY: " << m_primarySockets.size());
+  TCPWEB_LOG_FUNCTION("Secondary: " << m_secondarySockets.size());
   m_sendEvent = Simulator::Schedule (dt, &TcpWebClient::StartNewServerConnection, this, true);
 }
 
@@ -213,9 +272,10 @@ TcpWebClient::ScheduleTransmit (Time dt)
 void TcpWebClient::StartNewServerConnection(bool isPrimary){
 
 	//NS_LOG_FUNCTION (this << isPrimary);
-	//create new TCP socket
-	TypeId tid = TypeId::LookupByName ("ns3::TcpSocketFactory");
-	Ptr<Socket> newSocket = Socket::CreateSocket (GetNode(), tid);
+	//create new TCP socket (the pool has the factory of the node)
+	Ptr<Socket> newSocket = m_socketPool->Create();
+	TCPWEB_COUNT(CLIENT,SOCKETS_CREATED,1);
+	TCPWEB_EVENT(CLIENT_CONNECT,GetNode()->GetId(),isPrimary,0);
     // Fatal error if socket type is not NS3_SOCK_STREAM or NS3_SOCK_SEQPACKET
     if (newSocket->GetSocketType () != Socket::NS3_SOCK_STREAM &&
     		newSocket->GetSocketType () != Socket::NS3_SOCK_SEQPACKET)
@@ -224,7 +284,7 @@ void TcpWebClient::StartNewServerConnection(bool isPrimary){
                         "BulkSend requires SOCK_STREAM or SOCK_SEQPACKET. "
                         "In other words, use TCP instead of UDP.");
       }
-    NS_LOG_FUNCTION (this << newSocket);
+    TCPWEB_LOG_FUNCTION (this << newSocket);
     //reserve port on the machine
     newSocket->Bind();
     //initiate connection to remote machine
@@ -235,50 +295,39 @@ void TcpWebClient::StartNewServerConnection(bool isPrimary){
               MakeCallback (&TcpWebClient::ConnectionFailed, this));
     //set callback for when data is received over channel
     newSocket->SetRecvCallback (MakeCallback (&TcpWebClient::HandleRead, this));
-    NS_LOG_FUNCTION ("IS PRIMARY: " << isPrimary);
+    TCPWEB_LOG_FUNCTION ("IS PRIMARY: " << isPrimary);
     //push new socket back in proper category
     if(isPrimary){
     	m_primarySockets.push_back(newSocket);
     	m_primarySocketsDataRemaining.push_back(1);
+    	m_primarySocketsStart.push_back(Simulator::Now());
+    	m_primarySocketsResponseSize.push_back(0);
     }
     else{
     	m_secondarySockets.push_back(newSocket);
     	m_secondarySocketsDataRemaining.push_back(1);
+    	m_secondarySocketsStart.push_back(Simulator::Now());
+    	m_secondarySocketsResponseSize.push_back(0);
     }
 }
 
 //sends data over the TCP socket with the specified request size and response size
 //response size used by Web server to set request size
 void 
-TcpWebClient::Send (uint32_t requestSize, uint32_t responseSize, Ptr<Socket> socketToSend)
+TcpWebClient::Send (uint32_t requestSize, uint32_t responseSize, uint32_t objectId, uint8_t contentType, Ptr<Socket> socketToSend)
 {
-  NS_LOG_FUNCTION (this);
+  TCPWEB_LOG_FUNCTION (this);
 
   //NS_ASSERT (m_sendEvent.IsExpired ());
 
-  Ptr<Packet> p;
-
-  //allocates amount of data with reques size (in bytes)
-  uint8_t * packetData= new uint8_t[requestSize];
-  //puts request size in first 4 bytes
-  packetData[0]=(requestSize & 0xff000000) >> 24;
-  packetData[1]=(requestSize & 0x00ff0000) >> 16;
-  packetData[2]=(requestSize & 0x0000ff00) >> 8;
-  packetData[3]=(requestSize & 0x000000ff);
-  //puts response size in next 4 bytes
-  packetData[4]=(responseSize & 0xff000000) >> 24;
-  packetData[5]=(responseSize & 0x00ff0000) >> 16;
-  packetData[6]=(responseSize & 0x0000ff00) >> 8;
-  packetData[7]=(responseSize & 0x000000ff);
-  //creates a packet with the specified data
-  p = Create<Packet> (packetData,requestSize);
-  //clear packetData since packet created
-  delete[] packetData;
+  Ptr<Packet> p = CreateRequest (requestSize, responseSize, objectId, contentType);
   // call to the trace sinks before the packet is actually sent,
   // so that tags added to the packet can be sent as well
   m_txTrace (p);
   //send the packet
   socketToSend->Send(p);
+  TCPWEB_COUNT(CLIENT,TX_BYTES,requestSize);
+  TCPWEB_EVENT(CLIENT_REQUEST,GetNode()->GetId(),requestSize,responseSize);
   //NS_LOG_FUNCTION("" << socketToSend << p->GetSize());
   //increment the number of packets that have been sent
   ++m_sent;
@@ -288,50 +337,77 @@ TcpWebClient::Send (uint32_t requestSize, uint32_t responseSize, Ptr<Socket> soc
 		  m_timeOfLastSentPacket=Simulator::Now().GetSeconds();
   }
 }
+//request packet: requestSize bytes, header of request and response size (and object id, content type)
+Ptr<Packet>
+TcpWebClient::CreateRequest (uint32_t requestSize, uint32_t responseSize, uint32_t objectId, uint8_t contentType)
+{
+  WebRequestHeader header;
+  header.SetRequestSize (requestSize);
+  header.SetResponseSize (responseSize);
+  header.SetObjectId (objectId);
+  header.SetContentType (contentType);
+  NS_ASSERT (requestSize >= header.GetSerializedSize ());
+  //a zero filled packet of the request size (no buffer behind it) with the header in front
+  Ptr<Packet> p = Create<Packet> (requestSize-header.GetSerializedSize ());
+  TCPWEB_COUNT(CLIENT,PACKETS_CREATED,1);
+  p->AddHeader (header);
+  return p;
+}
 //callback for handling reading data out of the socket
 void
 TcpWebClient::HandleRead (Ptr<Socket> socket)
 {
-  NS_LOG_FUNCTION (this << socket);
+  TCPWEB_LOG_FUNCTION (this << socket);
   Ptr<Packet> packet;
   Address from;
   uint32_t totalDataReceived=0;
+  TCPWEB_COUNT(CLIENT,CALLBACKS,1);
   //JUST receive data from the socket (dont need to store any of it at all)
   while ((packet = socket->RecvFrom (from)))
     {
+#if TCPWEB_LOG_LEVEL >= TCPWEB_LOG_LEVEL_SEGMENT
       if (InetSocketAddress::IsMatchingType (from))
         {
-          NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client received " << packet->GetSize () << " bytes from " <<
+          TCPWEB_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client received " << packet->GetSize () << " bytes from " <<
                        InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " <<
                        InetSocketAddress::ConvertFrom (from).GetPort ());
         }
       else if (Inet6SocketAddress::IsMatchingType (from))
         {
-          NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client received " << packet->GetSize () << " bytes from " <<
+          TCPWEB_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client received " << packet->GetSize () << " bytes from " <<
                        Inet6SocketAddress::ConvertFrom (from).GetIpv6 () << " port " <<
                        Inet6SocketAddress::ConvertFrom (from).GetPort ());
         }
+#endif
+      TCPWEB_SEGMENT_EVENT(CLIENT_SEGMENT,GetNode()->GetId(),packet->GetSize(),0);
       totalDataReceived+=packet->GetSize();
+      TCPWEB_COUNT(CLIENT,RX_BYTES,packet->GetSize());
     }
   //check to see if all the data has been received for the socket (response fully sent)
   if(m_primarySockets.size()!=0){
 	  //if primary socket exists, there is no secondary connections and data has to be from it
 	  if(socket==m_primarySockets[0]){
 		  m_primarySocketsDataRemaining[0]-=totalDataReceived;
-		  NS_LOG_FUNCTION("TOTAL DATA REMAINING" << m_primarySocketsDataRemaining[0]);
+		  TCPWEB_LOG_FUNCTION("TOTAL DATA REMAINING" << m_primarySocketsDataRemaining[0]);
 		  //if received all data, spin off concurrent connections to fetch web objects
 		  if(m_primarySocketsDataRemaining[0]==0){
 			  //socket->Close(); (CAUSED ERRORS)
-			  //erase data for primary socket
+			  //erase data for primary socket, the pool closes it if configured to
+			  m_socketPool->Release(socket);
+			  m_objectCompleteTrace(m_primarySocketsResponseSize[0],Simulator::Now()-m_primarySocketsStart[0]);
 			  m_primarySockets.erase(m_primarySockets.begin());
 			  m_primarySocketsDataRemaining.erase(m_primarySocketsDataRemaining.begin());
+			  m_primarySocketsStart.erase(m_primarySocketsStart.begin());
+			  m_primarySocketsResponseSize.erase(m_primarySocketsResponseSize.begin());
+			  TCPWEB_COUNT(CLIENT,ERASES,4);
+			  TCPWEB_EVENT(CLIENT_OBJECT,GetNode()->GetId(),1,0);
 			  //spin up secondary sockets
 			  uint32_t numOfSecondarySocketsToSpin=0;
 			  if(m_maxConncurrentSockets>m_numFilesToFetch)
 				  numOfSecondarySocketsToSpin=m_numFilesToFetch;
 			  else
 				  numOfSecondarySocketsToSpin=m_maxConncurrentSockets;
-			  NS_LOG_FUNCTION("START NUM FILES:" << m_numFilesToFetch);
+			  TCPWEB_LOG_FUNCTION("START NUM FILES:" << m_numFilesToFetch);
 			  //spin off each new connection
 			  for(uint32_t i=m_secondarySockets.size();i<numOfSecondarySocketsToSpin;i++){
 				  StartNewServerConnection(false);
@@ -346,11 +422,17 @@ TcpWebClient::HandleRead (Ptr<Socket> socket)
 		  //if all data received, see if need to spin new connection to get another web object
 		  if(m_secondarySocketsDataRemaining[i]==0){
 			  m_numFilesToFetch--;
-			  NS_LOG_FUNCTION("NUM FILES" << m_numFilesToFetch);
+			  TCPWEB_LOG_FUNCTION("NUM FILES" << m_numFilesToFetch);
 			  //socket->Close();
 			  //clean up data around socket
+			  m_socketPool->Release(socket);
+			  m_objectCompleteTrace(m_secondarySocketsResponseSize[i],Simulator::Now()-m_secondarySocketsStart[i]);
 			  m_secondarySockets.erase(m_secondarySockets.begin()+i);
 			  m_secondarySocketsDataRemaining.erase(m_secondarySocketsDataRemaining.begin()+i);
+			  m_secondarySocketsStart.erase(m_secondarySocketsStart.begin()+i);
+			  m_secondarySocketsResponseSize.erase(m_secondarySocketsResponseSize.begin()+i);
+			  TCPWEB_COUNT(CLIENT,ERASES,4);
+			  TCPWEB_EVENT(CLIENT_OBJECT,GetNode()->GetId(),0,0);
 			  //spin up new connection if not all objects have been fetched or actively being fetched
 			  if(m_numFilesToFetch>m_secondarySockets.size() && m_secondarySockets.size()<m_maxConncurrentSockets){
 				  StartNewServerConnection(false);
@@ -362,13 +444,16 @@ TcpWebClient::HandleRead (Ptr<Socket> socket)
 				  //calculate response time
 				  a.requestExecutionTime=Simulator::Now().GetSeconds()-m_timeOfLastSentPacket;
 				  a.requestStart=m_timeOfLastSentPacket;
-				  m_responseTimes.push_back(a);
+				  if(m_storeResponseTimes)
+					  m_responseTimes.push_back(a);
+				  m_pageCompleteTrace(Seconds(a.requestStart),Seconds(a.requestExecutionTime));
+				  TCPWEB_EVENT(CLIENT_PAGE,GetNode()->GetId(),Seconds(a.requestExecutionTime).GetNanoSeconds(),0);
 				  //think time decreased by a factor of 10 (as in experiment)
 				  double thinkT=thinkTimeGenerator->GetValue()/10;
 				  Time thinkTime= Seconds(thinkT);
 				  //decrement number of pages that need to be fetched
 				  m_totalPagesToFetch--;
-				  NS_LOG_FUNCTION("TOT PAGES REM: " << m_totalPagesToFetch);
+				  TCPWEB_LOG_FUNCTION("TOT PAGES REM: " << m_totalPagesToFetch);
 				  if(m_totalPagesToFetch>0){
 					  //wait think time and schedule next transmit
 					  ScheduleTransmit(thinkTime);
@@ -384,46 +469,74 @@ TcpWebClient::HandleRead (Ptr<Socket> socket)
 //sets up the response and request size for the sockets
 void TcpWebClient::ConnectionSucceeded (Ptr<Socket> socket)
 {
-  NS_LOG_FUNCTION (this << socket);
+  TCPWEB_LOG_FUNCTION (this << socket);
+  TCPWEB_COUNT(CLIENT,CALLBACKS,1);
   uint32_t requestSize;
   uint32_t responseSize;
+  uint32_t objectId=WebRequestHeader::NO_OBJECT;
+  uint8_t contentType=WebRequestHeader::NO_CONTENT_TYPE;
+  //bytes the server sends back, less than asked for when it compresses the response
+  uint32_t expectedSize;
   if(m_primarySockets.size()!=0){
 	  if(socket==m_primarySockets[0]){
-		  NS_LOG_FUNCTION("CHECK PASSED");
+		  TCPWEB_LOG_FUNCTION("CHECK PASSED");
 		  //NS_LOG_FUNCTION (this << socket);
 		  //sockets are a match and its a primary socket
 		  //sample Distribution
 		  //worked with constant values
 		  requestSize=8+(uint32_t)primaryRequestSizeGenerator->GetValue();
 		  responseSize=8+(uint32_t)primaryResponseSizeGenerator->GetValue();
-		  NS_LOG_FUNCTION("PRIM RESPONSE SIZE: " << responseSize);
-		  NS_LOG_FUNCTION("PRIM REQUEST SIZE: " << requestSize);
+		  TCPWEB_LOG_FUNCTION("PRIM RESPONSE SIZE: " << responseSize);
+		  TCPWEB_LOG_FUNCTION("PRIM REQUEST SIZE: " << requestSize);
 		  m_numFilesToFetch=(uint32_t)numFilesToFetchGenerator->GetValue();
-		  m_primarySocketsDataRemaining[0]=responseSize;
+		  //the page is HTML
+		  expectedSize=responseSize;
+		  if(m_compression){
+			  contentType=WebCompressionModel::HTML;
+			  expectedSize=m_compression->GetEncodedSize(contentType,responseSize);
+		  }
+		  m_primarySocketsDataRemaining[0]=expectedSize;
+		  m_primarySocketsResponseSize[0]=expectedSize;
 		  //SECONDARY ALWAYS 0
 		  //NS_LOG_FUNCTION("IN PRIMARY" << m_secondarySockets.size());
 	  }
   }
   for(uint32_t i=0;i<m_secondarySockets.size();i++){
 	  if(socket==m_secondarySockets[i]){
-		  NS_LOG_FUNCTION("SECONDARY CHECK PASSED");
+		  TCPWEB_LOG_FUNCTION("SECONDARY CHECK PASSED");
 		  //NS_LOG_FUNCTION (this << socket);
 		  //sample distribution here as well (Secondary Distribution)
 		  requestSize=8+(uint32_t)secondaryRequestSizeGenerator->GetValue();
-		  responseSize=8+(uint32_t)secondaryResponseSizeGenerator->GetValue();
-		  m_secondarySocketsDataRemaining[i]=responseSize;
+		  if(m_catalog){
+			  //a known object: its fixed size, and 4 more request bytes for its id
+			  objectId=m_catalog->Sample(objectGenerator);
+			  responseSize=m_catalog->GetSize(objectId);
+			  requestSize+=4;
+		  }
+		  else{
+			  responseSize=8+(uint32_t)secondaryResponseSizeGenerator->GetValue();
+		  }
+		  //an object has the type of its id, a sized response that of its size
+		  expectedSize=responseSize;
+		  if(m_compression){
+			  contentType=m_compression->GetContentType(m_catalog ? objectId : responseSize);
+			  expectedSize=m_compression->GetEncodedSize(contentType,responseSize);
+		  }
+		  m_secondarySocketsDataRemaining[i]=expectedSize;
+		  m_secondarySocketsResponseSize[i]=expectedSize;
 	  }
   }
-  NS_LOG_FUNCTION("ACT RESPONSE SIZE: " << responseSize);
-  NS_LOG_FUNCTION("ACT REQUEST SIZE: " << requestSize);
+  TCPWEB_LOG_FUNCTION("ACT RESPONSE SIZE: " << responseSize);
+  TCPWEB_LOG_FUNCTION("ACT REQUEST SIZE: " << requestSize);
   //schedule transmit of the request over the socket
-  Send(requestSize,responseSize,socket);
+  Send(requestSize,responseSize,objectId,contentType,socket);
 }
 
 //callback for when TCP connection fails
 void TcpWebClient::ConnectionFailed (Ptr<Socket> socket)
 {
-  NS_LOG_FUNCTION (this << socket);
+  TCPWEB_LOG_FUNCTION (this << socket);
+  TCPWEB_COUNT(CLIENT,CALLBACKS,1);
 }
 
 //returns response time tracker for every request
@@ -25,11 +25,16 @@
 #include "ns3/ipv4-address.h"
 #include "ns3/traced-callback.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/nstime.h"
+#include "WebRequestHeader.h"
 #include <vector>
 namespace ns3 {
 
 class Socket;
 class Packet;
+class WebSocketPool;
+class WebObjectCatalog;
+class WebCompressionModel;
 //data stored for each request
 typedef struct
 {
@@ -70,10 +75,51 @@ public:
    */
   void SetRemote (Address ip, uint16_t port);
 
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  The streams are used in a fixed order, so the same
+   * starting stream always reproduces the same browsing session.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
 
+  //number of random variable streams each client consumes in AssignStreams
+  static const int64_t STREAMS_PER_CLIENT = 8;
 
   std::vector<RequestDataStruct> getResponseTimes();
 
+  /**
+   * \brief Build the request packet sent to the TcpWebServer
+   * \param requestSize bytes of the request, the header included
+   * \param responseSize bytes the server answers with
+   * \param objectId object asked for, WebRequestHeader::NO_OBJECT for none
+   * \param contentType of a response that may come compressed,
+   *        WebRequestHeader::NO_CONTENT_TYPE for an uncompressed one
+   * \return requestSize bytes, starting with requestSize then responseSize
+   *         (4 bytes each, big endian) and the object id if there is one
+   */
+  static Ptr<Packet> CreateRequest (uint32_t requestSize, uint32_t responseSize,
+                                    uint32_t objectId = WebRequestHeader::NO_OBJECT,
+                                    uint8_t contentType = WebRequestHeader::NO_CONTENT_TYPE);
+
+  /**
+   * TracedCallback signature for a completed page.
+   *
+   * \param [in] start time the primary request was sent
+   * \param [in] duration time until the last object of the page arrived
+   */
+  typedef void (* PageCompleteTracedCallback)(Time start, Time duration);
+
+  /**
+   * TracedCallback signature for a completed object (primary or secondary).
+   *
+   * \param [in] size response bytes
+   * \param [in] duration time from the start of its connection to its last byte
+   */
+  typedef void (* ObjectCompleteTracedCallback)(uint32_t size, Time duration);
+
 protected:
   virtual void DoDispose (void);
 
@@ -93,7 +139,7 @@ private:
    */
   void ScheduleTransmit (Time dt);
 
-  void Send (uint32_t requestSize, uint32_t responseSize, Ptr<Socket> socketToSend);
+  void Send (uint32_t requestSize, uint32_t responseSize, uint32_t objectId, uint8_t contentType, Ptr<Socket> socketToSend);
   /**
    * \brief Send a packet
    */
@@ -120,13 +166,22 @@ private:
   uint16_t m_peerPort; //!< Remote peer port
   EventId m_sendEvent; //!< Event to send the next packet
   std::vector<RequestDataStruct> m_responseTimes; //response time tracker for all requests
+  bool m_storeResponseTimes; //fill m_responseTimes
   double m_timeOfLastSentPacket; //holds time of last sent request
+  Ptr<WebSocketPool> m_socketPool; //of the node, where the sockets come from and go back to
+  Ptr<WebObjectCatalog> m_catalog; //of the server, what the secondary requests ask for (0 = sizes only)
+  Ptr<WebCompressionModel> m_compression; //of the server, the compressed sizes expected (0 = uncompressed)
   std::vector< Ptr<Socket> > m_primarySockets; //tracker for active primary socket
   std::vector< Ptr<Socket> > m_secondarySockets; //tracker for active secondary sockets
   //tracker for remaining data needed to be received by primary socket
   std::vector<uint32_t> m_primarySocketsDataRemaining;
   //tracker for remaining data needed to be received by each secondary socket
   std::vector<uint32_t> m_secondarySocketsDataRemaining;
+  //connection start and response size of each socket, for the ObjectComplete trace
+  std::vector<Time> m_primarySocketsStart;
+  std::vector<uint32_t> m_primarySocketsResponseSize;
+  std::vector<Time> m_secondarySocketsStart;
+  std::vector<uint32_t> m_secondarySocketsResponseSize;
   uint32_t m_maxConncurrentSockets; //max number of conncurrent TCP connecions
   uint32_t m_numFilesToFetch; //number of web objects to fetch per page
   uint32_t m_totalPagesToFetch; //number of pages to fetch in session
@@ -138,8 +193,13 @@ private:
   Ptr<EmpiricalRandomVariable> primaryResponseSizeGenerator;
   Ptr<EmpiricalRandomVariable> secondaryResponseSizeGenerator;
   Ptr<EmpiricalRandomVariable> totalPagesToFetchGenerator;
+  Ptr<UniformRandomVariable> objectGenerator; //uniform samples the catalog draws an object from
   /// Callbacks for tracing the packet Tx events
   TracedCallback<Ptr<const Packet> > m_txTrace;
+  /// Callbacks for tracing completed pages (start, response time)
+  TracedCallback<Time, Time> m_pageCompleteTrace;
+  /// Callbacks for tracing completed objects (size, fetch time)
+  TracedCallback<uint32_t, Time> m_objectCompleteTrace;
 };
 
 } // namespace ns3
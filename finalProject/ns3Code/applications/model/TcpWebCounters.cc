@@ -0,0 +1,66 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "TcpWebCounters.h"
+
+namespace ns3 {
+
+uint64_t TcpWebCounters::m_counts[TcpWebCounters::N_APPS][TcpWebCounters::N_COUNTERS];
+
+bool
+TcpWebCounters::IsEnabled (void)
+{
+#ifdef TCPWEB_COUNTERS
+  return true;
+#else
+  return false;
+#endif
+}
+
+uint64_t
+TcpWebCounters::Get (App app, Counter counter)
+{
+  return m_counts[app][counter];
+}
+
+const char *
+TcpWebCounters::GetAppName (App app)
+{
+  static const char *names[N_APPS] = { "client", "server" };
+  return names[app];
+}
+
+const char *
+TcpWebCounters::GetCounterName (Counter counter)
+{
+  static const char *names[N_COUNTERS] = { "callbacks", "rxBytes", "txBytes", "socketsCreated",
+                                           "socketsClosed", "packetsCreated", "copies",
+                                           "copiedBytes", "erases" };
+  return names[counter];
+}
+
+void
+TcpWebCounters::Reset (void)
+{
+  for (uint32_t a = 0; a < N_APPS; a++)
+    {
+      for (uint32_t c = 0; c < N_COUNTERS; c++)
+        {
+          m_counts[a][c] = 0;
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_WEB_COUNTERS_H
+#define TCP_WEB_COUNTERS_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Hot path counters of TcpWebClient and TcpWebServer
+ *
+ * The applications count their callbacks, the bytes they move, the sockets
+ * they create and close, the Packets they allocate, the payload copies
+ * (CopyData) and the erases of their per socket vectors with TCPWEB_COUNT.
+ * The macro only counts when the module is compiled with TCPWEB_COUNTERS
+ * defined (./waf configure --enable-tcpweb-counters), otherwise it expands
+ * to nothing and the applications carry no cost at all.  The counts are
+ * kept per process, summed over every instance, like those of
+ * WebCountingScheduler.
+ */
+class TcpWebCounters
+{
+public:
+  enum App
+  {
+    CLIENT,
+    SERVER,
+    N_APPS
+  };
+  enum Counter
+  {
+    CALLBACKS, //socket callbacks handled
+    RX_BYTES, //received from the sockets
+    TX_BYTES, //given to the sockets
+    SOCKETS_CREATED, //created or accepted
+    SOCKETS_CLOSED,
+    PACKETS_CREATED,
+    COPIES, //CopyData calls
+    COPIED_BYTES,
+    ERASES, //vector erases
+    N_COUNTERS
+  };
+
+  //true if the counters are compiled in
+  static bool IsEnabled (void);
+  static uint64_t Get (App app, Counter counter);
+  static const char * GetAppName (App app);
+  static const char * GetCounterName (Counter counter);
+  static void Reset (void);
+
+  //incremented by TCPWEB_COUNT only
+  static uint64_t m_counts[N_APPS][N_COUNTERS];
+};
+
+} // namespace ns3
+
+#ifdef TCPWEB_COUNTERS
+#define TCPWEB_COUNT(app, counter, n) \
+  (ns3::TcpWebCounters::m_counts[ns3::TcpWebCounters::app][ns3::TcpWebCounters::counter] += (n))
+#else
+#define TCPWEB_COUNT(app, counter, n) do { } while (false)
+#endif
+
+#endif /* TCP_WEB_COUNTERS_H */
@@ -0,0 +1,354 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "TcpWebProxy.h"
+#include "WebSocketPool.h"
+#include "WebEventLog.h"
+#include "WebCompressionModel.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/node.h"
+#include "ns3/socket.h"
+#include "ns3/packet.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "ns3/pointer.h"
+#include "ns3/trace-source-accessor.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpWebProxyApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpWebProxy);
+
+TypeId
+TcpWebProxy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpWebProxy")
+    .SetParent<Application> ()
+    .SetGroupName("Applications")
+    .AddConstructor<TcpWebProxy> ()
+    .AddAttribute ("Local",
+                   "The Address the clients connect to.",
+                   AddressValue (),
+                   MakeAddressAccessor (&TcpWebProxy::m_local),
+                   MakeAddressChecker ())
+    .AddAttribute ("Protocol",
+                   "The type id of the protocol to use for the rx socket.",
+                   TypeIdValue (TcpSocketFactory::GetTypeId ()),
+                   MakeTypeIdAccessor (&TcpWebProxy::m_tid),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("OriginPort",
+                   "The port of the origin servers.",
+                   UintegerValue (80),
+                   MakeUintegerAccessor (&TcpWebProxy::m_originPort),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("CacheBytes",
+                   "Capacity of the object cache in bytes.",
+                   UintegerValue (10000000),
+                   MakeUintegerAccessor (&TcpWebProxy::m_cacheBytes),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("Policy",
+                   "Which objects leave the cache first when it is full.",
+                   EnumValue (WebObjectCache::LRU),
+                   MakeEnumAccessor (&TcpWebProxy::m_policy),
+                   MakeEnumChecker (WebObjectCache::LRU, "LRU",
+                                    WebObjectCache::LFU, "LFU"))
+    .AddAttribute ("Compression",
+                   "Compression model of the origins, the sizes of the responses to requests with a "
+                   "content type (none: the origins answer with the size asked for).",
+                   PointerValue (),
+                   MakePointerAccessor (&TcpWebProxy::m_compression),
+                   MakePointerChecker<WebCompressionModel> ())
+    .AddTraceSource ("Lookup", "A complete request has been looked up in the cache",
+                     MakeTraceSourceAccessor (&TcpWebProxy::m_lookupTrace),
+                     "ns3::TcpWebProxy::LookupTracedCallback")
+  ;
+  return tid;
+}
+
+TcpWebProxy::TcpWebProxy ()
+  : m_originPort (80),
+    m_cacheBytes (0),
+    m_policy (WebObjectCache::LRU),
+    m_nextOrigin (0),
+    m_hits (0),
+    m_misses (0),
+    m_uncacheable (0),
+    m_hitBytes (0),
+    m_originBytes (0)
+{
+  TCPWEB_LOG_FUNCTION (this);
+}
+
+TcpWebProxy::~TcpWebProxy ()
+{
+  TCPWEB_LOG_FUNCTION (this);
+}
+
+void
+TcpWebProxy::AddOrigin (Ipv4Address address)
+{
+  TCPWEB_LOG_FUNCTION (this << address);
+  m_origins.push_back (address);
+}
+
+const WebObjectCache &
+TcpWebProxy::GetCache (void) const
+{
+  return m_cache;
+}
+
+uint64_t
+TcpWebProxy::GetHits (void) const
+{
+  return m_hits;
+}
+
+uint64_t
+TcpWebProxy::GetMisses (void) const
+{
+  return m_misses;
+}
+
+uint64_t
+TcpWebProxy::GetUncacheable (void) const
+{
+  return m_uncacheable;
+}
+
+uint64_t
+TcpWebProxy::GetHitBytes (void) const
+{
+  return m_hitBytes;
+}
+
+uint64_t
+TcpWebProxy::GetOriginBytes (void) const
+{
+  return m_originBytes;
+}
+
+void
+TcpWebProxy::DoDispose (void)
+{
+  TCPWEB_LOG_FUNCTION (this);
+  m_socket = 0;
+  m_exchanges.clear ();
+  m_clientOf.clear ();
+  m_compression = 0;
+  Application::DoDispose ();
+}
+
+void
+TcpWebProxy::StartApplication (void)
+{
+  TCPWEB_LOG_FUNCTION (this);
+  m_cache.SetPolicy (m_policy);
+  m_cache.SetCapacity (m_cacheBytes);
+  if (!m_socket)
+    {
+      m_socket = Socket::CreateSocket (GetNode (), m_tid);
+      m_socket->Bind (m_local);
+      m_socket->Listen ();
+    }
+  m_socket->SetAcceptCallback (
+    MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+    MakeCallback (&TcpWebProxy::HandleAccept, this));
+}
+
+void
+TcpWebProxy::StopApplication (void)
+{
+  TCPWEB_LOG_FUNCTION (this);
+  if (m_socket)
+    {
+      m_socket->Close ();
+    }
+  Ptr<WebSocketPool> pool = WebSocketPool::Get (GetNode ());
+  for (std::map<Ptr<Socket>, Exchange>::iterator it = m_exchanges.begin (); it != m_exchanges.end (); ++it)
+    {
+      it->first->Close ();
+      if (it->second.origin)
+        {
+          it->second.origin->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+          pool->Release (it->second.origin);
+        }
+    }
+  m_exchanges.clear ();
+  m_clientOf.clear ();
+}
+
+void
+TcpWebProxy::HandleAccept (Ptr<Socket> s, const Address &from)
+{
+  TCPWEB_LOG_FUNCTION (this << s << from);
+  s->SetRecvCallback (MakeCallback (&TcpWebProxy::HandleRead, this));
+  Exchange e;
+  e.received = 0;
+  e.requestSize = 0;
+  e.originReceived = 0;
+  m_exchanges[s] = e;
+}
+
+void
+TcpWebProxy::HandleRead (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      std::map<Ptr<Socket>, Exchange>::iterator it = m_exchanges.find (socket);
+      if (it == m_exchanges.end ())
+        {
+          continue;
+        }
+      Exchange &e = it->second;
+      //as TcpWebServer: only the header bytes are copied out, the rest is counted
+      if (e.received < WebRequestHeader::MAX_SIZE)
+        {
+          uint32_t n = std::min (WebRequestHeader::MAX_SIZE - e.received, packet->GetSize ());
+          uint8_t bytes[WebRequestHeader::MAX_SIZE];
+          packet->CopyData (bytes, n);
+          for (uint32_t k = 0; k < n; k++)
+            {
+              e.header[e.received + k] = bytes[k];
+            }
+          if (e.received < WebRequestHeader::SIZE && e.received + n >= WebRequestHeader::SIZE)
+            {
+              e.request.DeserializeBytes (e.header);
+              e.requestSize = e.request.GetRequestSize ();
+            }
+        }
+      e.received += packet->GetSize ();
+      if (e.received < WebRequestHeader::SIZE || e.received != e.requestSize || e.origin)
+        {
+          continue;
+        }
+      //whole request in: the object id bytes are there too now
+      e.request.DeserializeBytes (e.header);
+      uint32_t id = e.request.GetObjectId ();
+      uint32_t size;
+      if (e.request.HasObjectId () && m_cache.Lookup (id, size))
+        {
+          m_hits++;
+          m_hitBytes += size;
+          m_lookupTrace (id, e.request.GetResponseSize (), true);
+          TCPWEB_EVENT (PROXY_LOOKUP, GetNode ()->GetId (), id, 1);
+          Respond (socket, size);
+          continue;
+        }
+      m_misses++;
+      if (!e.request.HasObjectId ())
+        {
+          m_uncacheable++;
+        }
+      m_lookupTrace (id, e.request.GetResponseSize (), false);
+      TCPWEB_EVENT (PROXY_LOOKUP, GetNode ()->GetId (), id, 0);
+      //fetch it from its origin on a connection of its own
+      NS_ABORT_MSG_IF (m_origins.empty (), "TcpWebProxy on node " << GetNode ()->GetId () << " has no origin");
+      uint32_t origin = e.request.HasObjectId () ? id % m_origins.size () : m_nextOrigin++ % m_origins.size ();
+      e.origin = WebSocketPool::Get (GetNode ())->Create ();
+      e.origin->Bind ();
+      e.origin->Connect (InetSocketAddress (m_origins[origin], m_originPort));
+      e.origin->SetConnectCallback (MakeCallback (&TcpWebProxy::OriginConnected, this),
+                                    MakeCallback (&TcpWebProxy::OriginFailed, this));
+      e.origin->SetRecvCallback (MakeCallback (&TcpWebProxy::HandleOriginRead, this));
+      m_clientOf[e.origin] = socket;
+    }
+}
+
+void
+TcpWebProxy::OriginConnected (Ptr<Socket> origin)
+{
+  TCPWEB_LOG_FUNCTION (this << origin);
+  std::map<Ptr<Socket>, Ptr<Socket> >::iterator client = m_clientOf.find (origin);
+  if (client == m_clientOf.end ())
+    {
+      return;
+    }
+  //the client's request again, header first
+  const WebRequestHeader &request = m_exchanges[client->second].request;
+  Ptr<Packet> p = Create<Packet> (request.GetRequestSize () - request.GetSerializedSize ());
+  p->AddHeader (request);
+  origin->Send (p);
+}
+
+void
+TcpWebProxy::OriginFailed (Ptr<Socket> origin)
+{
+  TCPWEB_LOG_FUNCTION (this << origin);
+  std::map<Ptr<Socket>, Ptr<Socket> >::iterator client = m_clientOf.find (origin);
+  if (client == m_clientOf.end ())
+    {
+      return;
+    }
+  //nothing to answer with, the client connection is dropped
+  client->second->Close ();
+  m_exchanges.erase (client->second);
+  m_clientOf.erase (client);
+  WebSocketPool::Get (GetNode ())->Release (origin);
+}
+
+void
+TcpWebProxy::HandleOriginRead (Ptr<Socket> origin)
+{
+  Ptr<Packet> packet;
+  uint32_t received = 0;
+  while ((packet = origin->Recv ()))
+    {
+      received += packet->GetSize ();
+    }
+  m_originBytes += received;
+  std::map<Ptr<Socket>, Ptr<Socket> >::iterator client = m_clientOf.find (origin);
+  if (client == m_clientOf.end ())
+    {
+      return;
+    }
+  Exchange &e = m_exchanges[client->second];
+  e.originReceived += received;
+  uint32_t expected = e.request.GetResponseSize ();
+  if (m_compression && e.request.HasContentType ())
+    {
+      expected = m_compression->GetEncodedSize (e.request.GetContentType (), expected);
+    }
+  if (e.originReceived < expected)
+    {
+      return;
+    }
+  TCPWEB_LOG_INFO ("object " << e.request.GetObjectId () << " of " << e.originReceived << " bytes fetched");
+  if (e.request.HasObjectId ())
+    {
+      m_cache.Insert (e.request.GetObjectId (), e.originReceived);
+    }
+  Ptr<Socket> clientSocket = client->second;
+  uint32_t size = e.originReceived;
+  m_clientOf.erase (client);
+  WebSocketPool::Get (GetNode ())->Release (origin);
+  Respond (clientSocket, size);
+}
+
+void
+TcpWebProxy::Respond (Ptr<Socket> client, uint32_t size)
+{
+  Ptr<Packet> p = Create<Packet> (size);
+  client->Send (p);
+  client->Close ();
+  m_exchanges.erase (client);
+}
+
+} // namespace ns3
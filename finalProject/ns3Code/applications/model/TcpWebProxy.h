@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_WEB_PROXY_H
+#define TCP_WEB_PROXY_H
+
+#include "ns3/application.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+#include "ns3/address.h"
+#include "ns3/ipv4-address.h"
+#include "WebObjectCache.h"
+#include "WebRequestHeader.h"
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+class Socket;
+class Packet;
+class WebCompressionModel;
+
+/**
+ * \ingroup applications
+ *
+ * \brief Caching reverse proxy between TcpWebClients and TcpWebServers
+ *
+ * Accepts the client connections in place of the origin servers, on a
+ * node in front of the bottleneck.  A request with an object id (clients
+ * with a WebObjectCatalog) whose object is in the WebObjectCache is
+ * answered at once.  Any other request is a miss: it is sent again on a
+ * new connection to an origin, object id modulo the number of origins
+ * (requests without an id go round robin), and once the whole response
+ * is in, the object is cached and the response sent to the client.  The
+ * proxy stores and forwards, so a miss costs the origin round trip plus
+ * the transfer of the response over the bottleneck before its first byte
+ * goes to the client.  Requests are forwarded as they came, so the origin
+ * compresses what the client accepts compressed; with the Compression model
+ * of the origins the proxy knows how many bytes to wait for, and caches the
+ * compressed object.
+ */
+class TcpWebProxy : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TcpWebProxy ();
+  virtual ~TcpWebProxy ();
+
+  /**
+   * \brief Add a server misses are fetched from, at the OriginPort
+   *
+   * The origin added i-th gets the objects whose id modulo the number of
+   * origins is i, the WebObjectCatalog of server i with IdOffset i and
+   * IdStride the number of servers.
+   */
+  void AddOrigin (Ipv4Address address);
+
+  const WebObjectCache &GetCache (void) const;
+  //requests answered from the cache, fetched from an origin, and of those without an object id
+  uint64_t GetHits (void) const;
+  uint64_t GetMisses (void) const;
+  uint64_t GetUncacheable (void) const;
+  //response bytes sent from the cache, and received from the origins
+  uint64_t GetHitBytes (void) const;
+  uint64_t GetOriginBytes (void) const;
+
+  /**
+   * TracedCallback signature for a request looked up in the cache.
+   *
+   * \param [in] objectId the object asked for (WebRequestHeader::NO_OBJECT without one)
+   * \param [in] size the response size asked for
+   * \param [in] hit whether the cache held it
+   */
+  typedef void (* LookupTracedCallback)(uint32_t objectId, uint32_t size, bool hit);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  void HandleAccept (Ptr<Socket> socket, const Address &from);
+  //request data from a client
+  void HandleRead (Ptr<Socket> socket);
+  void OriginConnected (Ptr<Socket> origin);
+  void OriginFailed (Ptr<Socket> origin);
+  //response data from an origin
+  void HandleOriginRead (Ptr<Socket> origin);
+  //sends a response of size bytes to the client and forgets the exchange
+  void Respond (Ptr<Socket> client, uint32_t size);
+
+  //a client connection and, on a miss, its origin connection
+  typedef struct
+  {
+    uint32_t received; //request bytes so far
+    uint32_t requestSize; //from the header, once its first 8 bytes are in
+    uint8_t header[WebRequestHeader::MAX_SIZE];
+    WebRequestHeader request; //decoded once the request is complete
+    Ptr<Socket> origin; //0 until a miss opens it
+    uint32_t originReceived; //response bytes from the origin so far
+  } Exchange;
+
+  Ptr<Socket> m_socket; //listening socket
+  Address m_local;
+  TypeId m_tid;
+  uint16_t m_originPort;
+  uint64_t m_cacheBytes;
+  WebObjectCache::Policy m_policy;
+  Ptr<WebCompressionModel> m_compression; //of the origins (0 = they answer uncompressed)
+  std::vector<Ipv4Address> m_origins;
+  uint32_t m_nextOrigin; //round robin of the requests without an object id
+  WebObjectCache m_cache;
+  std::map<Ptr<Socket>, Exchange> m_exchanges; //by client socket
+  std::map<Ptr<Socket>, Ptr<Socket> > m_clientOf; //client socket of each origin socket
+  uint64_t m_hits;
+  uint64_t m_misses;
+  uint64_t m_uncacheable;
+  uint64_t m_hitBytes;
+  uint64_t m_originBytes;
+
+  TracedCallback<uint32_t, uint32_t, bool> m_lookupTrace;
+};
+
+} // namespace ns3
+
+#endif /* TCP_WEB_PROXY_H */
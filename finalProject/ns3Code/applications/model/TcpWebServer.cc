@@ -31,7 +31,16 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/tcp-socket-factory.h"
 #include "TcpWebServer.h"
+#include "TcpWebCounters.h"
+#include "WebEventLog.h"
+#include "WebRequestHeader.h"
+#include "WebObjectCatalog.h"
+#include "WebCompressionModel.h"
+#include "ns3/pointer.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include <algorithm>
 
 namespace ns3 {
 //unique component name
@@ -56,6 +65,37 @@ TcpWebServer::GetTypeId (void)
                    TypeIdValue (TcpSocketFactory::GetTypeId ()),
                    MakeTypeIdAccessor (&TcpWebServer::m_tid),
                    MakeTypeIdChecker ())
+    .AddAttribute ("Catalog",
+                   "The objects served: requests for one of them are answered with its size and counted "
+                   "(none: every request gets the response size it asks for)",
+                   PointerValue (),
+                   MakePointerAccessor (&TcpWebServer::m_catalog),
+                   MakePointerChecker<WebObjectCatalog> ())
+    .AddAttribute ("Scheduler",
+                   "Order the responses are handed to TCP in: None (each whole at once), FIFO, SRPT "
+                   "(fewest bytes left first) or FairShare (round robin), a Quantum at a time",
+                   EnumValue (TcpWebServer::NONE),
+                   MakeEnumAccessor (&TcpWebServer::m_scheduler),
+                   MakeEnumChecker (TcpWebServer::NONE, "None",
+                                    TcpWebServer::FIFO, "FIFO",
+                                    TcpWebServer::SRPT, "SRPT",
+                                    TcpWebServer::FAIR, "FairShare"))
+    .AddAttribute ("Quantum",
+                   "Bytes of a response the scheduler hands to TCP at once",
+                   UintegerValue (1460),
+                   MakeUintegerAccessor (&TcpWebServer::m_quantum),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("ServiceRate",
+                   "Rate the scheduler hands quanta to TCP at (0bps: as fast as the send buffers take them)",
+                   DataRateValue (DataRate ("100Mbps")),
+                   MakeDataRateAccessor (&TcpWebServer::m_serviceRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("Compression",
+                   "Compresses the responses of requests with a content type, the worker of the "
+                   "Scheduler spends its CPU time (none = responses are sent as asked for)",
+                   PointerValue (),
+                   MakePointerAccessor (&TcpWebServer::m_compression),
+                   MakePointerChecker<WebCompressionModel> ())
     .AddTraceSource ("Rx",
                      "A packet has been received",
                      MakeTraceSourceAccessor (&TcpWebServer::m_rxTrace),
@@ -63,33 +103,50 @@ TcpWebServer::GetTypeId (void)
 	.AddTraceSource ("Tx", "A new packet is created and is sent",
 					 MakeTraceSourceAccessor (&TcpWebServer::m_txTrace),
 					 "ns3::Packet::TracedCallback")
+	.AddTraceSource ("ResponseComplete", "The last byte of a response has been handed to TCP: size and time since its request",
+					 MakeTraceSourceAccessor (&TcpWebServer::m_responseCompleteTrace),
+					 "ns3::TcpWebServer::ResponseCompleteTracedCallback")
+	.AddTraceSource ("Quantum", "The scheduler has handed a quantum of a response to TCP",
+					 MakeTraceSourceAccessor (&TcpWebServer::m_quantumTrace),
+					 "ns3::TcpWebServer::QuantumTracedCallback")
 	;
   return tid;
 }
 
 TcpWebServer::TcpWebServer ()
 {
-  NS_LOG_FUNCTION (this);
+  TCPWEB_LOG_FUNCTION (this);
   m_socket = 0;
   m_totalRx = 0;
   m_totalDataSent=0;
+  m_poolHits = 0;
+  m_poolMisses = 0;
+  m_slotsUsed = 0;
+  m_scheduler = NONE;
+  m_quantum = 1460;
+  m_nextFair = 0;
+  m_quanta = 0;
+  m_maxResponses = 0;
+  m_compressedResponses = 0;
+  m_identityBytes = 0;
+  m_encodedBytes = 0;
 }
 
 TcpWebServer::~TcpWebServer()
 {
-  NS_LOG_FUNCTION (this);
+  TCPWEB_LOG_FUNCTION (this);
 }
 
 uint32_t TcpWebServer::GetTotalRx () const
 {
-  NS_LOG_FUNCTION (this);
+  TCPWEB_LOG_FUNCTION (this);
   return m_totalRx;
 }
 
 Ptr<Socket>
 TcpWebServer::GetListeningSocket (void) const
 {
-  NS_LOG_FUNCTION (this);
+  TCPWEB_LOG_FUNCTION (this);
   return m_socket;
 }
 
@@ -97,16 +154,20 @@ TcpWebServer::GetListeningSocket (void) const
 std::vector<Ptr<Socket> >
 TcpWebServer::GetAcceptedSockets (void) const
 {
-  NS_LOG_FUNCTION (this);
+  TCPWEB_LOG_FUNCTION (this);
   return m_socketList;
 }
 
 //called when simulation ends
 void TcpWebServer::DoDispose (void)
 {
-  NS_LOG_FUNCTION (this);
+  TCPWEB_LOG_FUNCTION (this);
   m_socket = 0;
   m_socketList.clear ();
+  m_requests.clear ();
+  m_responses.clear ();
+  m_catalog = 0;
+  m_compression = 0;
 
   // chain up
   Application::DoDispose ();
@@ -116,7 +177,13 @@ void TcpWebServer::DoDispose (void)
 // Application Methods
 void TcpWebServer::StartApplication ()    // Called at time specified by Start
 {
-  NS_LOG_FUNCTION (this);
+  TCPWEB_LOG_FUNCTION (this);
+  if (m_catalog)
+    {
+      m_objectRequests.resize (m_catalog->GetNObjects (), 0);
+    }
+  NS_ABORT_MSG_IF (m_compression && m_scheduler == NONE,
+                   "TcpWebServer Compression needs a Scheduler, its worker pays the compression time");
   // Create the socket and bind and listen
   if (!m_socket)
     {
@@ -152,7 +219,7 @@ void TcpWebServer::StartApplication ()    // Called at time specified by Start
 
 void TcpWebServer::StopApplication ()     // Called at time specified by Stop
 {
-  NS_LOG_FUNCTION (this);
+  TCPWEB_LOG_FUNCTION (this);
   if (m_socket)
     {
       m_socket->Close ();
@@ -160,8 +227,16 @@ void TcpWebServer::StopApplication ()     // Called at time specified by Stop
     }
   for(uint32_t i=0;i<m_socketList.size();i++){
 	  m_socketList[i]->Close();
+	  TCPWEB_COUNT(SERVER,SOCKETS_CLOSED,1);
   }
   m_socketList.clear();
+  m_requests.clear();
+  //responses still held are cut off
+  Simulator::Cancel(m_serviceEvent);
+  for(uint32_t i=0;i<m_responses.size();i++){
+	  m_responses[i].socket->Close();
+  }
+  m_responses.clear();
 }
 
 void TcpWebServer::HandleRead (Ptr<Socket> socket)
@@ -169,12 +244,15 @@ void TcpWebServer::HandleRead (Ptr<Socket> socket)
   //NS_LOG_FUNCTION (this << socket);
   Ptr<Packet> packet;
   Address from;
+  TCPWEB_COUNT(SERVER,CALLBACKS,1);
   while ((packet = socket->RecvFrom (from)))
     {
       m_totalRx += packet->GetSize ();
+      TCPWEB_COUNT(SERVER,RX_BYTES,packet->GetSize());
+#if TCPWEB_LOG_LEVEL >= TCPWEB_LOG_LEVEL_SEGMENT
       if (InetSocketAddress::IsMatchingType (from))
         {
-          NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds ()
+          TCPWEB_LOG_INFO ("At time " << Simulator::Now ().GetSeconds ()
                        << "s packet sink received "
                        <<  packet->GetSize () << " bytes from "
                        << InetSocketAddress::ConvertFrom(from).GetIpv4 ()
@@ -183,13 +261,15 @@ void TcpWebServer::HandleRead (Ptr<Socket> socket)
         }
       else if (Inet6SocketAddress::IsMatchingType (from))
         {
-          NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds ()
+          TCPWEB_LOG_INFO ("At time " << Simulator::Now ().GetSeconds ()
                        << "s packet sink received "
                        <<  packet->GetSize () << " bytes from "
                        << Inet6SocketAddress::ConvertFrom(from).GetIpv6 ()
                        << " port " << Inet6SocketAddress::ConvertFrom (from).GetPort ()
                        << " total Rx " << m_totalRx << " bytes");
         }
+#endif
+      TCPWEB_SEGMENT_EVENT(SERVER_SEGMENT,GetNode()->GetId(),packet->GetSize(),0);
 
 
       m_rxTrace (packet, from);
@@ -200,75 +280,297 @@ void TcpWebServer::HandleRead (Ptr<Socket> socket)
       //m_txTrace (p);
       //socket->SendTo (p, 0, from);
       //socket->Close();
-      //check which socket data received from
-      for(uint32_t i=0;i<m_socketList.size();i++){
-    	  if(socket==m_socketList[i]){
-    		  //append packet data
-    		  m_inTransitPackets[i]->AddAtEnd(packet);
-    		  //if received first 8 bytes can get request size (seems to constantly get it every time data received
-    		  //TODO: can be optimized by only getting it once (check if m_totalRequestSize initialized)
-    		  if(m_inTransitPackets[i]->GetSize()-packet->GetSize()<8 && m_inTransitPackets[i]->GetSize()>=8){
-    			  uint8_t* packetData= new uint8_t[m_inTransitPackets[i]->GetSize()];
-    			  packet->CopyData(packetData,m_inTransitPackets[i]->GetSize());
-    			  uint32_t requestSize= ((uint32_t)packetData[0]) << 24;
-    			  requestSize= (requestSize + ((uint32_t)packetData[1]) ) << 16;
-    			  requestSize= (requestSize + ((uint32_t)packetData[2]) ) << 8;
-    			  requestSize= requestSize + ((uint32_t)packetData[3]);
-    			  NS_LOG_FUNCTION("INIT PACKET REQUEST SIZE" << requestSize);
-    			  m_totalRequestSize[i]=requestSize;
-    			  delete[] packetData;
-    		  }
-    		  //then check to see if total data received
-    		  if(m_totalRequestSize[i]==m_inTransitPackets[i]->GetSize()){
-    			  //if so send response data
-    			  NS_LOG_FUNCTION("CompleteResponseSize:" << m_inTransitPackets[i]->GetSize());
-    			  uint8_t* packetData= new uint8_t[m_inTransitPackets[i]->GetSize()];
-    			  m_inTransitPackets[i]->CopyData(packetData,m_inTransitPackets[i]->GetSize());
-    			  //get total response size (next 4 bytes)
-    			  uint32_t responseSize= ((uint32_t)packetData[4]) << 24;
-    			  responseSize= responseSize + (((uint32_t)packetData[5])  << 16);
-    			  responseSize= responseSize + (((uint32_t)packetData[6])  << 8);
-    			  responseSize= responseSize + ((uint32_t)packetData[7]);
-    			  //NS_LOG_FUNCTION("Response Size:" << responseSize);
-    			  //create the packet (size is response size and send)
-    			  Ptr<Packet> p = Create<Packet>(responseSize);
-    			  socket->Send(p);
-    			  socket->Close();
-    			  //NS_LOG_INFO("DONEEEEE WITH PACKETTSSSS");
-    			  //clear socket since we are finished sending data
-    			  m_inTransitPackets.erase(m_inTransitPackets.begin()+i);
-    			  m_totalRequestSize.erase(m_totalRequestSize.begin()+i);
-    			  m_socketList.erase(m_socketList.begin()+i);
-    		  }
-    		  break;
+      //find the connection the data belongs to
+      int32_t i=FindConnection(socket);
+      if(i<0){
+    	  continue;
+      }
+      uint32_t responseSize;
+      if(AddRequestData(i,packet,responseSize)){
+    	  if(m_scheduler==NONE){
+    		  //whole request in, create the packet (size is response size and send)
+    		  Ptr<Packet> p = Create<Packet>(responseSize);
+    		  socket->Send(p);
+    		  socket->Close();
+    		  TCPWEB_COUNT(SERVER,PACKETS_CREATED,1);
+    		  TCPWEB_COUNT(SERVER,TX_BYTES,responseSize);
+    		  TCPWEB_COUNT(SERVER,SOCKETS_CLOSED,1);
+    		  m_responseCompleteTrace(responseSize,Seconds(0));
+    	  }
+    	  else{
+    		  //the worker sends it in quanta, in the scheduler's order
+    		  Enqueue(socket,responseSize,m_requests[i].cpu);
     	  }
+    	  TCPWEB_EVENT(SERVER_RESPONSE,GetNode()->GetId(),m_requests[i].requestSize,responseSize);
+    	  //clear socket since we are finished sending data
+    	  RemoveConnection(i);
       }
     }
 }
 
+int32_t
+TcpWebServer::FindConnection (Ptr<Socket> socket) const
+{
+  for(uint32_t i=0;i<m_socketList.size();i++){
+	  if(socket==m_socketList[i]){
+		  return i;
+	  }
+  }
+  return -1;
+}
+
+bool
+TcpWebServer::AddRequestData (uint32_t i, Ptr<Packet> packet, uint32_t &responseSize)
+{
+  RequestState &r=m_requests[i];
+  //only the header bytes are copied out (those of an object id too), the rest of the request is counted
+  if(r.received<WebRequestHeader::MAX_SIZE){
+	  uint32_t n=std::min(WebRequestHeader::MAX_SIZE-r.received,packet->GetSize());
+	  uint8_t bytes[WebRequestHeader::MAX_SIZE];
+	  packet->CopyData(bytes,n);
+	  TCPWEB_COUNT(SERVER,COPIES,1);
+	  TCPWEB_COUNT(SERVER,COPIED_BYTES,n);
+	  for(uint32_t k=0;k<n;k++){
+		  r.header[r.received+k]=bytes[k];
+	  }
+	  if(r.received<WebRequestHeader::SIZE && r.received+n>=WebRequestHeader::SIZE){
+		  WebRequestHeader header;
+		  header.DeserializeBytes(r.header);
+		  r.requestSize=header.GetRequestSize();
+		  TCPWEB_LOG_FUNCTION("INIT PACKET REQUEST SIZE" << r.requestSize);
+	  }
+  }
+  r.received+=packet->GetSize();
+  //then check to see if total data received
+  if(r.received<WebRequestHeader::SIZE || r.requestSize!=r.received){
+	  return false;
+  }
+  TCPWEB_LOG_FUNCTION("CompleteResponseSize:" << r.received);
+  //get total response size (next 4 bytes)
+  WebRequestHeader header;
+  header.DeserializeBytes(r.header);
+  responseSize=header.GetResponseSize();
+  //an object of the catalog has its own size, whatever the request says
+  if(m_catalog && header.HasObjectId() && m_catalog->Contains(header.GetObjectId())){
+	  uint32_t rank=m_catalog->GetRank(header.GetObjectId());
+	  responseSize=m_catalog->GetSize(header.GetObjectId());
+	  if(rank<m_objectRequests.size()){
+		  m_objectRequests[rank]++;
+	  }
+  }
+  //a client accepting a compressed response gets the size the model compresses it to
+  r.cpu=Seconds(0);
+  if(m_compression && header.HasContentType() && m_compression->IsCompressed(header.GetContentType(),responseSize)){
+	  uint32_t identitySize=responseSize;
+	  responseSize=m_compression->GetEncodedSize(header.GetContentType(),identitySize);
+	  r.cpu=m_compression->GetCpuTime(header.GetContentType(),identitySize);
+	  m_compressedResponses++;
+	  m_identityBytes+=identitySize;
+	  m_encodedBytes+=responseSize;
+	  m_compressionTime+=r.cpu;
+  }
+  return true;
+}
+
+void
+TcpWebServer::AddConnection (Ptr<Socket> socket)
+{
+  //nothing received yet; below the most connections ever held the slot was
+  //filled before and freed by RemoveConnection, a new one takes it over
+  if(m_requests.size()<m_slotsUsed){
+	  m_poolHits++;
+  }
+  else{
+	  m_poolMisses++;
+	  m_slotsUsed++;
+  }
+  RequestState r;
+  r.received=0;
+  r.requestSize=0;
+  r.cpu=Seconds(0);
+  m_socketList.push_back (socket);
+  m_requests.push_back(r);
+}
+
+void
+TcpWebServer::RemoveConnection (uint32_t i)
+{
+  //the last connection takes the place of the removed one, nothing is shifted
+  m_socketList[i]=m_socketList.back();
+  m_socketList.pop_back();
+  m_requests[i]=m_requests.back();
+  m_requests.pop_back();
+}
+
+void
+TcpWebServer::Enqueue (Ptr<Socket> socket, uint32_t size, Time cpu)
+{
+  Response r;
+  r.socket=socket;
+  r.size=size;
+  r.remaining=size;
+  r.queued=Simulator::Now();
+  r.cpuPerByte=size>0 ? cpu.GetSeconds()/size : 0;
+  m_responses.push_back(r);
+  m_maxResponses=std::max(m_maxResponses,(uint32_t)m_responses.size());
+  socket->SetSendCallback(MakeCallback(&TcpWebServer::HandleSend,this));
+  //an idle worker starts at once, a busy one picks it up after its quantum
+  if(!m_serviceEvent.IsRunning()){
+	  Serve();
+  }
+}
+
+int32_t
+TcpWebServer::PickResponse (void)
+{
+  int32_t best=-1;
+  for(uint32_t k=0;k<m_responses.size();k++){
+	  //FAIR looks from where the round robin stopped
+	  uint32_t i=m_scheduler==FAIR ? (m_nextFair+k)%m_responses.size() : k;
+	  const Response &r=m_responses[i];
+	  if(r.socket->GetTxAvailable()<std::min(m_quantum,r.remaining)){
+		  continue;
+	  }
+	  if(m_scheduler!=SRPT){
+		  return i;
+	  }
+	  if(best<0 || r.remaining<m_responses[best].remaining){
+		  best=i;
+	  }
+  }
+  return best;
+}
+
+void
+TcpWebServer::Serve (void)
+{
+  int32_t i=PickResponse();
+  if(i<0){
+	  //idle, or every socket full: HandleSend wakes the worker up
+	  return;
+  }
+  Response &r=m_responses[i];
+  uint32_t n=std::min(m_quantum,r.remaining);
+  //compressing the quantum's share of the response comes on top of handing it over
+  double service=n*r.cpuPerByte;
+  r.socket->Send(Create<Packet>(n));
+  r.remaining-=n;
+  m_quanta++;
+  TCPWEB_COUNT(SERVER,PACKETS_CREATED,1);
+  TCPWEB_COUNT(SERVER,TX_BYTES,n);
+  m_quantumTrace(r.size,n,m_responses.size());
+  m_nextFair=i+1;
+  if(r.remaining==0){
+	  r.socket->Close();
+	  TCPWEB_COUNT(SERVER,SOCKETS_CLOSED,1);
+	  m_responseCompleteTrace(r.size,Simulator::Now()-r.queued);
+	  //erased in place, FIFO and FAIR depend on the order
+	  m_responses.erase(m_responses.begin()+i);
+	  TCPWEB_COUNT(SERVER,ERASES,1);
+	  m_nextFair=i;
+  }
+  if(m_nextFair>=m_responses.size()){
+	  m_nextFair=0;
+  }
+  if(m_serviceRate.GetBitRate()>0){
+	  service+=m_serviceRate.CalculateTxTime(n);
+  }
+  m_serviceEvent=Simulator::Schedule(Seconds(service),&TcpWebServer::Serve,this);
+}
+
+void
+TcpWebServer::HandleSend (Ptr<Socket> socket, uint32_t available)
+{
+  TCPWEB_COUNT(SERVER,CALLBACKS,1);
+  if(!m_serviceEvent.IsRunning()){
+	  Serve();
+  }
+}
+
+uint64_t
+TcpWebServer::GetCompressedResponses (void) const
+{
+  return m_compressedResponses;
+}
+
+uint64_t
+TcpWebServer::GetIdentityBytes (void) const
+{
+  return m_identityBytes;
+}
+
+uint64_t
+TcpWebServer::GetEncodedBytes (void) const
+{
+  return m_encodedBytes;
+}
+
+Time
+TcpWebServer::GetCompressionTime (void) const
+{
+  return m_compressionTime;
+}
+
+uint64_t
+TcpWebServer::GetQuanta (void) const
+{
+  return m_quanta;
+}
+
+uint32_t
+TcpWebServer::GetMaxResponses (void) const
+{
+  return m_maxResponses;
+}
+
+uint64_t
+TcpWebServer::GetPoolHits (void) const
+{
+  return m_poolHits;
+}
+
+uint64_t
+TcpWebServer::GetPoolMisses (void) const
+{
+  return m_poolMisses;
+}
+
+Ptr<WebObjectCatalog>
+TcpWebServer::GetCatalog (void) const
+{
+  return m_catalog;
+}
+
+const std::vector<uint32_t> &
+TcpWebServer::GetObjectRequests (void) const
+{
+  return m_objectRequests;
+}
+
 //callback if peer closes the tcp socket
 void TcpWebServer::HandlePeerClose (Ptr<Socket> socket)
 {
-  NS_LOG_FUNCTION (this << socket);
+  TCPWEB_LOG_FUNCTION (this << socket);
+  TCPWEB_COUNT(SERVER,CALLBACKS,1);
 }
 //callback for error on TCP socket
 void TcpWebServer::HandlePeerError (Ptr<Socket> socket)
 {
-  NS_LOG_FUNCTION (this << socket);
+  TCPWEB_LOG_FUNCTION (this << socket);
+  TCPWEB_COUNT(SERVER,CALLBACKS,1);
 }
 
 //callback to handle a client connection
 void TcpWebServer::HandleAccept (Ptr<Socket> s, const Address& from)
 {
-  NS_LOG_FUNCTION (this << s << from);
+  TCPWEB_LOG_FUNCTION (this << s << from);
+  TCPWEB_COUNT(SERVER,CALLBACKS,1);
+  TCPWEB_COUNT(SERVER,SOCKETS_CREATED,1);
+  TCPWEB_EVENT(SERVER_ACCEPT,GetNode()->GetId(),0,0);
   //sets receive callback for the newly accepted socket
   s->SetRecvCallback (MakeCallback (&TcpWebServer::HandleRead, this));
   //add socket to active socket list and initialize total request data and request size
-  //inTransitPackets acts as buffer to hold intermidary data until request all comes in
-  //total Request size is used to know when all packet data arrives
-  m_socketList.push_back (s);
-  m_inTransitPackets.push_back(Create<Packet>());
-  m_totalRequestSize.push_back(500000000);
+  AddConnection (s);
 }
 
 
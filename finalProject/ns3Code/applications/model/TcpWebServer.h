@@ -26,12 +26,17 @@
 #include "ns3/ptr.h"
 #include "ns3/traced-callback.h"
 #include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "WebRequestHeader.h"
 
 namespace ns3 {
 
 class Address;
 class Socket;
 class Packet;
+class WebObjectCatalog;
+class WebCompressionModel;
 
 /**
  * \ingroup applications
@@ -75,6 +80,27 @@ public:
   static TypeId GetTypeId (void);
   TcpWebServer ();
 
+  /**
+   * Order the answered responses are handed to TCP in (Scheduler attribute)
+   *
+   * NONE hands every response to its socket whole, as soon as the request
+   * is in.  The others keep the responses in the server: its worker hands
+   * one Quantum of one response at a time to TCP, taking the time of the
+   * quantum at the ServiceRate, and picks the response of the quantum among
+   * those whose socket has room for it:
+   *   FIFO  the oldest response
+   *   SRPT  the response with the fewest bytes left (shortest remaining
+   *         processing time first)
+   *   FAIR  round robin over the responses, a quantum each
+   */
+  enum Scheduler
+  {
+    NONE,
+    FIFO,
+    SRPT,
+    FAIR
+  };
+
   virtual ~TcpWebServer ();
 
   /**
@@ -92,6 +118,69 @@ public:
    */
   std::vector<Ptr<Socket> > GetAcceptedSockets (void) const;
 
+  /**
+   * \return connections whose request state reused the slot of an answered
+   * connection, and those that needed a new slot
+   */
+  uint64_t GetPoolHits (void) const;
+  uint64_t GetPoolMisses (void) const;
+
+  //the objects served (Catalog attribute), 0 without one
+  Ptr<WebObjectCatalog> GetCatalog (void) const;
+  /**
+   * \return requests of every object of the catalog, by popularity rank
+   * (empty without a catalog)
+   */
+  const std::vector<uint32_t> &GetObjectRequests (void) const;
+
+  //quanta handed to TCP, and the most responses held at once (Scheduler other than NONE)
+  uint64_t GetQuanta (void) const;
+  uint32_t GetMaxResponses (void) const;
+
+  /**
+   * \return responses compressed (Compression attribute), their bytes
+   * before and after compression and the worker time spent compressing them
+   */
+  uint64_t GetCompressedResponses (void) const;
+  uint64_t GetIdentityBytes (void) const;
+  uint64_t GetEncodedBytes (void) const;
+  Time GetCompressionTime (void) const;
+
+  /**
+   * TracedCallback signature for a response whose last byte went to TCP.
+   *
+   * \param [in] size response bytes
+   * \param [in] sojourn time from the complete request to the last quantum
+   */
+  typedef void (* ResponseCompleteTracedCallback)(uint32_t size, Time sojourn);
+
+  /**
+   * TracedCallback signature for a quantum handed to TCP.
+   *
+   * \param [in] size bytes of the response the quantum belongs to
+   * \param [in] quantum bytes handed to TCP
+   * \param [in] responses responses held by the scheduler, this one included
+   */
+  typedef void (* QuantumTracedCallback)(uint32_t size, uint32_t quantum, uint32_t responses);
+
+  /*
+   * Request state of the accepted connections, what HandleAccept and
+   * HandleRead do apart from the socket calls (public for webBench)
+   */
+  //adds a connection with nothing received yet
+  void AddConnection (Ptr<Socket> socket);
+  //index of the connection of socket, -1 if it is not an accepted socket
+  int32_t FindConnection (Ptr<Socket> socket) const;
+  /**
+   * \brief Append a received segment to the request of a connection
+   * \param connection index from FindConnection
+   * \param packet the segment
+   * \param responseSize set to the size asked for once the request is complete
+   * \return true when the whole request has arrived
+   */
+  bool AddRequestData (uint32_t connection, Ptr<Packet> packet, uint32_t &responseSize);
+  void RemoveConnection (uint32_t connection);
+
 protected:
   virtual void DoDispose (void);
 private:
@@ -120,13 +209,62 @@ private:
    * \param socket the connected socket
    */
   void HandlePeerError (Ptr<Socket> socket);
+  /**
+   * \brief Handle room in the send buffer of a socket with a held response
+   * \param socket the connected socket
+   * \param available bytes of room
+   */
+  void HandleSend (Ptr<Socket> socket, uint32_t available);
+
+  //holds a response for the scheduler and wakes the worker, cpu is its compression time
+  void Enqueue (Ptr<Socket> socket, uint32_t size, Time cpu);
+  //the worker: hands one quantum to TCP, then waits for its service time
+  void Serve (void);
+  //index in m_responses of the response of the next quantum, -1 if no socket has room
+  int32_t PickResponse (void);
 
   // In the case of TCP, each socket accept returns a new socket, so the
   // listening socket is stored separately from the accepted sockets
   Ptr<Socket>     m_socket;       //!< Listening socket
+  //what is kept of a request until it is complete: its size and the header bytes, not its data
+  typedef struct
+  {
+    uint32_t received; //request bytes so far
+    uint32_t requestSize; //from the header, once its first 8 bytes are in
+    uint8_t header[WebRequestHeader::MAX_SIZE];
+    Time cpu; //compression time of the response, once the request is complete
+  } RequestState;
+
   std::vector<Ptr<Socket> > m_socketList; //!< the accepted sockets
-  std::vector< Ptr<Packet> > m_inTransitPackets;
-  std::vector< uint32_t > m_totalRequestSize;
+  std::vector<RequestState> m_requests; //of m_socketList[i]; the slots of answered ones are reused
+  uint64_t m_poolHits; //connections that reused the slot of an answered one
+  uint64_t m_poolMisses; //connections for which the slots had to grow
+  uint32_t m_slotsUsed; //most connections held at once, the slots below it have been filled before
+  Ptr<WebObjectCatalog> m_catalog; //objects served, the sizes of requests with an object id
+  std::vector<uint32_t> m_objectRequests; //by rank in m_catalog
+  Ptr<WebCompressionModel> m_compression; //compresses the responses of requests with a content type (0 = none)
+  uint64_t m_compressedResponses;
+  uint64_t m_identityBytes; //of the compressed responses, before compression
+  uint64_t m_encodedBytes; //and after
+  Time m_compressionTime; //worker time charged for compressing
+  //an answered response the scheduler holds until it has all gone to TCP
+  typedef struct
+  {
+    Ptr<Socket> socket;
+    uint32_t size;
+    uint32_t remaining; //not handed to TCP yet
+    Time queued; //when its request was complete
+    double cpuPerByte; //compression seconds charged with every byte handed to TCP
+  } Response;
+
+  Scheduler m_scheduler;
+  uint32_t m_quantum; //bytes handed to TCP at once
+  DataRate m_serviceRate; //of the worker handing quanta to TCP (0 = no limit)
+  std::vector<Response> m_responses; //in the order their requests completed
+  uint32_t m_nextFair; //FAIR: index the round robin continues at
+  EventId m_serviceEvent; //end of the service time of the last quantum
+  uint64_t m_quanta;
+  uint32_t m_maxResponses;
   uint32_t m_totalDataSent; //to see load;
 
   Address         m_local;        //!< Local address to bind to
@@ -137,6 +275,8 @@ private:
   /// Traced Callback: received packets, source address.
   TracedCallback<Ptr<const Packet>, const Address &> m_rxTrace;
   TracedCallback<Ptr<const Packet> > m_txTrace;
+  TracedCallback<uint32_t, Time> m_responseCompleteTrace;
+  TracedCallback<uint32_t, uint32_t, uint32_t> m_quantumTrace;
 
 };
 
@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebCompressionModel.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WebCompressionModel");
+
+NS_OBJECT_ENSURE_REGISTERED (WebCompressionModel);
+
+TypeId
+WebCompressionModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WebCompressionModel")
+    .SetParent<Object> ()
+    .SetGroupName("Applications")
+    .AddConstructor<WebCompressionModel> ()
+    .AddAttribute ("HtmlRatio",
+                   "Mean compressed/uncompressed size of HTML responses (1: not compressed).",
+                   DoubleValue (0.25),
+                   MakeDoubleAccessor (&WebCompressionModel::m_htmlRatio),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("TextRatio",
+                   "Mean compressed/uncompressed size of style sheets and scripts (1: not compressed).",
+                   DoubleValue (0.3),
+                   MakeDoubleAccessor (&WebCompressionModel::m_textRatio),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("ImageRatio",
+                   "Mean compressed/uncompressed size of images (1: not compressed).",
+                   DoubleValue (1),
+                   MakeDoubleAccessor (&WebCompressionModel::m_imageRatio),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("OtherRatio",
+                   "Mean compressed/uncompressed size of the other objects (1: not compressed).",
+                   DoubleValue (0.6),
+                   MakeDoubleAccessor (&WebCompressionModel::m_otherRatio),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("RatioSpread",
+                   "Ratios are uniform in the mean ratio of the type +- this.",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&WebCompressionModel::m_ratioSpread),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("TextShare",
+                   "Share of the secondary objects that are style sheets and scripts.",
+                   DoubleValue (0.35),
+                   MakeDoubleAccessor (&WebCompressionModel::m_textShare),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("ImageShare",
+                   "Share of the secondary objects that are images.",
+                   DoubleValue (0.45),
+                   MakeDoubleAccessor (&WebCompressionModel::m_imageShare),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("MinSize",
+                   "Responses smaller than this many bytes are sent as is.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&WebCompressionModel::m_minSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("CpuPerByte",
+                   "Server time to compress one byte.",
+                   TimeValue (NanoSeconds (20)),
+                   MakeTimeAccessor (&WebCompressionModel::m_cpuPerByte),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+WebCompressionModel::WebCompressionModel ()
+  : m_htmlRatio (0.25),
+    m_textRatio (0.3),
+    m_imageRatio (1),
+    m_otherRatio (0.6),
+    m_ratioSpread (0.1),
+    m_textShare (0.35),
+    m_imageShare (0.45),
+    m_minSize (1000)
+{
+}
+
+//a uniform [0,1) value of key, the same on every node (murmur3 finalizer)
+static double
+Hash (uint32_t key, uint32_t salt)
+{
+  uint32_t h = key ^ (salt * 0x9e3779b9);
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h / 4294967296.0;
+}
+
+uint8_t
+WebCompressionModel::GetContentType (uint32_t key) const
+{
+  double u = Hash (key, N_CONTENT_TYPES);
+  if (u < m_textShare)
+    {
+      return TEXT;
+    }
+  if (u < m_textShare + m_imageShare)
+    {
+      return IMAGE;
+    }
+  return OTHER;
+}
+
+double
+WebCompressionModel::GetRatio (uint8_t type) const
+{
+  switch (type)
+    {
+    case HTML:
+      return m_htmlRatio;
+    case TEXT:
+      return m_textRatio;
+    case IMAGE:
+      return m_imageRatio;
+    case OTHER:
+      return m_otherRatio;
+    default:
+      return 1;
+    }
+}
+
+bool
+WebCompressionModel::IsCompressed (uint8_t type, uint32_t size) const
+{
+  return GetRatio (type) < 1 && size >= m_minSize && size > 8;
+}
+
+uint32_t
+WebCompressionModel::GetEncodedSize (uint8_t type, uint32_t size) const
+{
+  if (!IsCompressed (type, size))
+    {
+      return size;
+    }
+  double ratio = GetRatio (type) + m_ratioSpread * (2 * Hash (size, type) - 1);
+  ratio = std::min (1.0, std::max (0.01, ratio));
+  //at least one body byte, never more than uncompressed
+  uint32_t body = std::max (1.0, std::ceil ((size - 8) * ratio));
+  return 8 + std::min (body, size - 8);
+}
+
+Time
+WebCompressionModel::GetCpuTime (uint8_t type, uint32_t size) const
+{
+  if (!IsCompressed (type, size))
+    {
+      return Seconds (0);
+    }
+  return Seconds (m_cpuPerByte.GetSeconds () * size);
+}
+
+std::string
+WebCompressionModel::GetContentTypeName (uint8_t type)
+{
+  const char *names[] = {"html", "text", "image", "other"};
+  return type < N_CONTENT_TYPES ? names[type] : "none";
+}
+
+} // namespace ns3
@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef WEB_COMPRESSION_MODEL_H
+#define WEB_COMPRESSION_MODEL_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Compressed response sizes and the server CPU time they cost
+ *
+ * Every response has a content type: the pages are HTML, the secondary
+ * objects text (style sheets, scripts), images or other, in the shares of
+ * the TextShare and ImageShare attributes.  A response of at least MinSize
+ * bytes whose type has a mean ratio below 1 is compressed: its body (the
+ * response less its 8 header bytes) shrinks by a ratio drawn uniformly from
+ * the type's mean ratio +- RatioSpread, and the server spends CpuPerByte of
+ * its worker for every uncompressed byte.
+ *
+ * The browser, the server and a proxy in between all have to agree on the
+ * size of a compressed response, so nothing here is drawn from a random
+ * stream: the type of an object and the ratio of a response are hashed from
+ * their key (the object id, or the uncompressed size) and every side that
+ * shares the model (or an identically configured one) computes the same
+ * sizes.  The request carries the content type (WebRequestHeader), the
+ * response only the compressed bytes.
+ */
+class WebCompressionModel : public Object
+{
+public:
+  enum ContentType
+  {
+    HTML = 0,
+    TEXT,
+    IMAGE,
+    OTHER,
+    N_CONTENT_TYPES
+  };
+
+  static TypeId GetTypeId (void);
+
+  WebCompressionModel ();
+
+  //content type of the secondary object of key (object id or response size)
+  uint8_t GetContentType (uint32_t key) const;
+  //whether responses of the type and size are compressed
+  bool IsCompressed (uint8_t type, uint32_t size) const;
+  /**
+   * \param size uncompressed response size, header included
+   * \return the size of the response sent
+   */
+  uint32_t GetEncodedSize (uint8_t type, uint32_t size) const;
+  //server time to compress the response, zero if it is sent as is
+  Time GetCpuTime (uint8_t type, uint32_t size) const;
+
+  static std::string GetContentTypeName (uint8_t type);
+
+private:
+  //mean compressed/uncompressed body size of the type
+  double GetRatio (uint8_t type) const;
+
+  double m_htmlRatio;
+  double m_textRatio;
+  double m_imageRatio;
+  double m_otherRatio;
+  double m_ratioSpread;
+  double m_textShare;
+  double m_imageShare;
+  uint32_t m_minSize;
+  Time m_cpuPerByte;
+};
+
+} // namespace ns3
+
+#endif /* WEB_COMPRESSION_MODEL_H */
@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebCountingScheduler.h"
+
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WebCountingScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (WebCountingScheduler);
+
+uint64_t WebCountingScheduler::m_processed = 0;
+uint64_t WebCountingScheduler::m_inserted = 0;
+uint64_t WebCountingScheduler::m_removed = 0;
+
+TypeId
+WebCountingScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WebCountingScheduler")
+    .SetParent<MapScheduler> ()
+    .SetGroupName("Applications")
+    .AddConstructor<WebCountingScheduler> ()
+  ;
+  return tid;
+}
+
+WebCountingScheduler::WebCountingScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+WebCountingScheduler::~WebCountingScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+WebCountingScheduler::Insert (const Event &ev)
+{
+  m_inserted++;
+  MapScheduler::Insert (ev);
+}
+
+Scheduler::Event
+WebCountingScheduler::RemoveNext (void)
+{
+  m_processed++;
+  return MapScheduler::RemoveNext ();
+}
+
+void
+WebCountingScheduler::Remove (const Event &ev)
+{
+  m_removed++;
+  MapScheduler::Remove (ev);
+}
+
+uint64_t
+WebCountingScheduler::GetProcessed (void)
+{
+  return m_processed;
+}
+
+uint64_t
+WebCountingScheduler::GetInserted (void)
+{
+  return m_inserted;
+}
+
+uint64_t
+WebCountingScheduler::GetRemoved (void)
+{
+  return m_removed;
+}
+
+} // Namespace ns3
@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WEB_COUNTING_SCHEDULER_H
+#define WEB_COUNTING_SCHEDULER_H
+
+#include "ns3/map-scheduler.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief The default (map) scheduler, counting the events it hands out
+ *
+ * Every RemoveNext is one processed event (run, or skipped if it was
+ * cancelled with EventId::Cancel); events removed with Simulator::Remove
+ * are counted apart.  The simulator owns its scheduler, so the
+ * counts are kept per process and read through the static getters.
+ * Select it before scheduling anything:
+ *
+ *   ObjectFactory f ("ns3::WebCountingScheduler");
+ *   Simulator::SetScheduler (f);
+ */
+class WebCountingScheduler : public MapScheduler
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  WebCountingScheduler ();
+  virtual ~WebCountingScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+  //events processed, scheduled and removed by all instances of this process
+  static uint64_t GetProcessed (void);
+  static uint64_t GetInserted (void);
+  static uint64_t GetRemoved (void);
+
+private:
+  static uint64_t m_processed;
+  static uint64_t m_inserted;
+  static uint64_t m_removed;
+};
+
+} // namespace ns3
+
+#endif /* WEB_COUNTING_SCHEDULER_H */
@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebEventLog.h"
+#include "WebResultFile.h"
+#include "ns3/simulator.h"
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WebEventLog");
+
+WebResultWriter *WebEventLog::m_writer = 0;
+uint32_t WebEventLog::m_table = 0;
+uint64_t WebEventLog::m_records = 0;
+
+bool
+WebEventLog::Open (const std::string &filename)
+{
+  NS_LOG_FUNCTION (filename);
+  Close ();
+  m_writer = new WebResultWriter ();
+  if (!m_writer->Open (filename))
+    {
+      delete m_writer;
+      m_writer = 0;
+      return false;
+    }
+  m_writer->SetConfig ("program", "WebEventLog");
+  std::ostringstream level;
+  level << TCPWEB_LOG_LEVEL;
+  m_writer->SetConfig ("logLevel", level.str ());
+  m_table = m_writer->AddTable ("events");
+  m_writer->AddColumn (m_table, "time", WebResultFile::TIME);
+  m_writer->AddColumn (m_table, "node", WebResultFile::UINT64);
+  m_writer->AddColumn (m_table, "event", WebResultFile::UINT64);
+  m_writer->AddColumn (m_table, "a", WebResultFile::UINT64);
+  m_writer->AddColumn (m_table, "b", WebResultFile::UINT64);
+  m_records = 0;
+  return true;
+}
+
+void
+WebEventLog::Close (void)
+{
+  if (m_writer)
+    {
+      m_writer->Close ();
+      delete m_writer;
+      m_writer = 0;
+    }
+}
+
+bool
+WebEventLog::IsOpen (void)
+{
+  return m_writer != 0;
+}
+
+void
+WebEventLog::Record (Event event, uint32_t node, uint64_t a, uint64_t b)
+{
+  m_writer->AddTime (m_table, 0, Simulator::Now ().GetSeconds ());
+  m_writer->AddUint64 (m_table, 1, node);
+  m_writer->AddUint64 (m_table, 2, event);
+  m_writer->AddUint64 (m_table, 3, a);
+  m_writer->AddUint64 (m_table, 4, b);
+  m_writer->EndRow (m_table);
+  m_records++;
+}
+
+uint64_t
+WebEventLog::GetNRecords (void)
+{
+  return m_records;
+}
+
+} // namespace ns3
@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef WEB_EVENT_LOG_H
+#define WEB_EVENT_LOG_H
+
+#include <stdint.h>
+#include <string>
+#include "ns3/log.h"
+
+/*
+ * Compile time logging of TcpWebClient, TcpWebServer and TcpWebProxy.
+ * TCPWEB_LOG_LEVEL (./waf configure --tcpweb-log-level=N) is the highest
+ * level compiled in, the macros of the levels above it expand to nothing:
+ *   0  nothing
+ *   1  connection events (connect, request, object and page done, accept,
+ *      response, proxy lookup) to the WebEventLog
+ *   2  also one event per received segment, and the NS_LOG_INFO texts
+ *   3  also NS_LOG_FUNCTION (every callback)
+ * The default is 3 when ns-3 logging is compiled in (debug builds) and 1
+ * otherwise, so optimized builds do no logging work per segment at all.
+ */
+#define TCPWEB_LOG_LEVEL_EVENT 1
+#define TCPWEB_LOG_LEVEL_SEGMENT 2
+#define TCPWEB_LOG_LEVEL_FUNCTION 3
+
+#ifndef TCPWEB_LOG_LEVEL
+#ifdef NS3_LOG_ENABLE
+#define TCPWEB_LOG_LEVEL TCPWEB_LOG_LEVEL_FUNCTION
+#else
+#define TCPWEB_LOG_LEVEL TCPWEB_LOG_LEVEL_EVENT
+#endif
+#endif
+
+#if TCPWEB_LOG_LEVEL >= TCPWEB_LOG_LEVEL_EVENT
+#define TCPWEB_EVENT(event, node, a, b) \
+  do { if (ns3::WebEventLog::IsOpen ()) { ns3::WebEventLog::Record (ns3::WebEventLog::event, node, a, b); } } while (false)
+#else
+#define TCPWEB_EVENT(event, node, a, b) do { } while (false)
+#endif
+
+#if TCPWEB_LOG_LEVEL >= TCPWEB_LOG_LEVEL_SEGMENT
+#define TCPWEB_SEGMENT_EVENT(event, node, a, b) TCPWEB_EVENT (event, node, a, b)
+#define TCPWEB_LOG_INFO(msg) NS_LOG_INFO (msg)
+#else
+#define TCPWEB_SEGMENT_EVENT(event, node, a, b) do { } while (false)
+#define TCPWEB_LOG_INFO(msg) do { } while (false)
+#endif
+
+#if TCPWEB_LOG_LEVEL >= TCPWEB_LOG_LEVEL_FUNCTION
+#define TCPWEB_LOG_FUNCTION(parameters) NS_LOG_FUNCTION (parameters)
+#else
+#define TCPWEB_LOG_FUNCTION(parameters) do { } while (false)
+#endif
+
+namespace ns3 {
+
+class WebResultWriter;
+
+/**
+ * \ingroup applications
+ *
+ * \brief Structured binary log of the TcpWeb application events
+ *
+ * Records are rows of the "events" table of a WebResultFile: time, node,
+ * event and two event specific values (see Event), so resultConvert and
+ * graphs/webResults.py read them like any other result.  The applications
+ * record through the TCPWEB_EVENT macros, only while a log is open and only
+ * for the levels compiled in.  One log per process.
+ */
+class WebEventLog
+{
+public:
+  enum Event
+  {
+    CLIENT_CONNECT, //a: 1 primary, 0 secondary connection
+    CLIENT_REQUEST, //a: request size, b: response size
+    CLIENT_SEGMENT, //a: bytes received
+    CLIENT_OBJECT, //a: 1 primary, 0 secondary object complete
+    CLIENT_PAGE, //a: response time in nanoseconds
+    SERVER_ACCEPT,
+    SERVER_SEGMENT, //a: bytes received
+    SERVER_RESPONSE, //a: request size, b: response size
+    PROXY_LOOKUP //a: object id, b: 1 cache hit, 0 miss
+  };
+
+  static bool Open (const std::string &filename);
+  static void Close (void);
+  static bool IsOpen (void);
+  static void Record (Event event, uint32_t node, uint64_t a, uint64_t b);
+  //records written since Open
+  static uint64_t GetNRecords (void);
+
+private:
+  static WebResultWriter *m_writer;
+  static uint32_t m_table;
+  static uint64_t m_records;
+};
+
+} // namespace ns3
+
+#endif /* WEB_EVENT_LOG_H */
@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebObjectCache.h"
+
+namespace ns3 {
+
+bool
+WebObjectCache::Key::operator< (const struct Key &o) const
+{
+  if (uses != o.uses)
+    {
+      return uses < o.uses;
+    }
+  if (lastUse != o.lastUse)
+    {
+      return lastUse < o.lastUse;
+    }
+  return id < o.id;
+}
+
+WebObjectCache::WebObjectCache ()
+  : m_policy (LRU),
+    m_capacity (0),
+    m_bytes (0),
+    m_clock (0),
+    m_evictions (0)
+{
+}
+
+void
+WebObjectCache::SetPolicy (Policy policy)
+{
+  m_policy = policy;
+}
+
+WebObjectCache::Policy
+WebObjectCache::GetPolicy (void) const
+{
+  return m_policy;
+}
+
+void
+WebObjectCache::SetCapacity (uint64_t bytes)
+{
+  m_capacity = bytes;
+}
+
+uint64_t
+WebObjectCache::GetCapacity (void) const
+{
+  return m_capacity;
+}
+
+void
+WebObjectCache::Touch (Entry &e)
+{
+  m_order.erase (e.key);
+  if (m_policy == LFU)
+    {
+      e.key.uses++;
+    }
+  e.key.lastUse = m_clock++;
+  m_order.insert (e.key);
+}
+
+bool
+WebObjectCache::Lookup (uint32_t id, uint32_t &size)
+{
+  std::map<uint32_t, Entry>::iterator it = m_entries.find (id);
+  if (it == m_entries.end ())
+    {
+      return false;
+    }
+  Touch (it->second);
+  size = it->second.size;
+  return true;
+}
+
+void
+WebObjectCache::Insert (uint32_t id, uint32_t size)
+{
+  if (size > m_capacity)
+    {
+      return;
+    }
+  std::map<uint32_t, Entry>::iterator it = m_entries.find (id);
+  if (it != m_entries.end ())
+    {
+      //fetched again by two misses at the same time
+      Touch (it->second);
+      return;
+    }
+  while (m_bytes + size > m_capacity)
+    {
+      std::set<Key>::iterator victim = m_order.begin ();
+      std::map<uint32_t, Entry>::iterator e = m_entries.find (victim->id);
+      m_bytes -= e->second.size;
+      m_entries.erase (e);
+      m_order.erase (victim);
+      m_evictions++;
+    }
+  Entry e;
+  e.size = size;
+  e.key.uses = m_policy == LFU ? 1 : 0;
+  e.key.lastUse = m_clock++;
+  e.key.id = id;
+  m_entries[id] = e;
+  m_order.insert (e.key);
+  m_bytes += size;
+}
+
+uint64_t
+WebObjectCache::GetBytes (void) const
+{
+  return m_bytes;
+}
+
+uint32_t
+WebObjectCache::GetNObjects (void) const
+{
+  return m_entries.size ();
+}
+
+uint64_t
+WebObjectCache::GetEvictions (void) const
+{
+  return m_evictions;
+}
+
+} // namespace ns3
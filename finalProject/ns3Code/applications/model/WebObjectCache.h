@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef WEB_OBJECT_CACHE_H
+#define WEB_OBJECT_CACHE_H
+
+#include <stdint.h>
+#include <map>
+#include <set>
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Sizes of the objects a TcpWebProxy holds, bounded in bytes
+ *
+ * Only object ids and sizes are kept, as the simulated payloads carry no
+ * data.  When an insert does not fit, objects are evicted in the order of
+ * the policy: LRU the least recently used first, LFU the least often used
+ * first (the least recently used of those on a tie).  Both orders are kept
+ * in one set keyed (uses, last use, id), uses being 0 under LRU, so a
+ * lookup, an insert and an eviction all cost O(log n).
+ */
+class WebObjectCache
+{
+public:
+  enum Policy
+  {
+    LRU,
+    LFU
+  };
+
+  WebObjectCache ();
+
+  void SetPolicy (Policy policy);
+  Policy GetPolicy (void) const;
+  //bytes of objects held at most
+  void SetCapacity (uint64_t bytes);
+  uint64_t GetCapacity (void) const;
+
+  /**
+   * \param id object asked for
+   * \param size set to the object size on a hit
+   * \return true if the object is held (it then counts as used)
+   */
+  bool Lookup (uint32_t id, uint32_t &size);
+  /**
+   * \brief Hold an object, evicting others until it fits
+   *
+   * Objects larger than the capacity are not held.
+   */
+  void Insert (uint32_t id, uint32_t size);
+
+  uint64_t GetBytes (void) const;
+  uint32_t GetNObjects (void) const;
+  uint64_t GetEvictions (void) const;
+
+private:
+  //eviction order: smallest first
+  typedef struct Key
+  {
+    uint64_t uses;
+    uint64_t lastUse;
+    uint32_t id;
+    bool operator< (const struct Key &o) const;
+  } Key;
+  typedef struct
+  {
+    uint32_t size;
+    Key key;
+  } Entry;
+
+  void Touch (Entry &e);
+
+  Policy m_policy;
+  uint64_t m_capacity;
+  uint64_t m_bytes; //of the held objects
+  uint64_t m_clock; //lookups and inserts so far, the time of a use
+  uint64_t m_evictions;
+  std::map<uint32_t, Entry> m_entries;
+  std::set<Key> m_order;
+};
+
+} // namespace ns3
+
+#endif /* WEB_OBJECT_CACHE_H */
@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebObjectCatalog.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/uinteger.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/http-distributions.h"
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WebObjectCatalog");
+
+NS_OBJECT_ENSURE_REGISTERED (WebObjectCatalog);
+
+TypeId
+WebObjectCatalog::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WebObjectCatalog")
+    .SetParent<Object> ()
+    .SetGroupName("Applications")
+    .AddConstructor<WebObjectCatalog> ()
+    .AddAttribute ("IdOffset",
+                   "Id of the most popular object.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&WebObjectCatalog::m_idOffset),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("IdStride",
+                   "Difference of the ids of consecutive popularity ranks.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&WebObjectCatalog::m_idStride),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+WebObjectCatalog::WebObjectCatalog ()
+  : m_idOffset (0),
+    m_idStride (1),
+    m_alpha (0),
+    m_hIntegralX1 (0),
+    m_hIntegralN (0),
+    m_s (0)
+{
+}
+
+//log(1+x)/x and (exp(x)-1)/x, by their series near 0
+static double
+Helper1 (double x)
+{
+  return std::fabs (x) > 1e-8 ? log1p (x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+}
+
+static double
+Helper2 (double x)
+{
+  return std::fabs (x) > 1e-8 ? expm1 (x) / x : 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x));
+}
+
+//the unnormalized probability of rank x (from 1), 1/x^alpha
+double
+WebObjectCatalog::H (double x) const
+{
+  return std::exp (-m_alpha * std::log (x));
+}
+
+//integral of H from 1 to x
+double
+WebObjectCatalog::HIntegral (double x) const
+{
+  double logX = std::log (x);
+  return Helper2 ((1 - m_alpha) * logX) * logX;
+}
+
+double
+WebObjectCatalog::HIntegralInverse (double x) const
+{
+  double t = x * (1 - m_alpha);
+  if (t < -1)
+    {
+      t = -1;
+    }
+  return std::exp (Helper1 (t) * x);
+}
+
+void
+WebObjectCatalog::Build (uint32_t n, double alpha, int64_t stream)
+{
+  NS_LOG_FUNCTION (this << n << alpha << stream);
+  NS_ABORT_MSG_IF (n == 0, "a catalog needs at least one object");
+  NS_ABORT_MSG_IF (alpha < 0, "the Zipf exponent cannot be negative");
+  NS_ABORT_MSG_IF ((uint64_t)m_idOffset + (uint64_t)(n - 1) * m_idStride >= 0xffffffff,
+                   "the object ids of the catalog do not fit in 32 bits");
+  m_alpha = alpha;
+  m_hIntegralX1 = HIntegral (1.5) - 1;
+  m_hIntegralN = HIntegral (n + 0.5);
+  m_s = 2 - HIntegralInverse (HIntegral (2.5) - H (2));
+  Ptr<EmpiricalRandomVariable> sizes = CreateObject<EmpiricalRandomVariable> ();
+  for (uint32_t i = 0; i < sizeof(httpDist::secondaryReply) / sizeof(httpDist::intd_t); i++)
+    {
+      sizes->CDF (httpDist::secondaryReply[i].i, httpDist::secondaryReply[i].d);
+    }
+  sizes->SetStream (stream);
+  m_sizes.resize (n);
+  for (uint32_t k = 0; k < n; k++)
+    {
+      //as TcpWebClient sizes a secondary response: 8 bytes more than the sample
+      m_sizes[k] = 8 + (uint32_t)sizes->GetValue ();
+    }
+}
+
+uint32_t
+WebObjectCatalog::GetNObjects (void) const
+{
+  return m_sizes.size ();
+}
+
+double
+WebObjectCatalog::GetAlpha (void) const
+{
+  return m_alpha;
+}
+
+uint64_t
+WebObjectCatalog::GetMemoryBytes (void) const
+{
+  return (uint64_t)m_sizes.capacity () * sizeof(uint32_t);
+}
+
+uint32_t
+WebObjectCatalog::Sample (Ptr<RandomVariableStream> uniform) const
+{
+  NS_ASSERT (!m_sizes.empty ());
+  uint32_t n = m_sizes.size ();
+  //invert the integral of H at a uniform point, keep the rank unless it falls
+  //in the part of its cell the continuous density overestimates
+  while (true)
+    {
+      double u = m_hIntegralN + uniform->GetValue () * (m_hIntegralX1 - m_hIntegralN);
+      double x = HIntegralInverse (u);
+      uint32_t k = x < 1.5 ? 1 : (x >= n ? n : (uint32_t)(x + 0.5));
+      if (k - x <= m_s || u >= HIntegral (k + 0.5) - H (k))
+        {
+          return GetId (k - 1);
+        }
+    }
+}
+
+bool
+WebObjectCatalog::Contains (uint32_t id) const
+{
+  return id >= m_idOffset && (id - m_idOffset) % m_idStride == 0
+         && (id - m_idOffset) / m_idStride < m_sizes.size ();
+}
+
+uint32_t
+WebObjectCatalog::GetRank (uint32_t id) const
+{
+  NS_ASSERT (Contains (id));
+  return (id - m_idOffset) / m_idStride;
+}
+
+uint32_t
+WebObjectCatalog::GetId (uint32_t rank) const
+{
+  return m_idOffset + rank * m_idStride;
+}
+
+uint32_t
+WebObjectCatalog::GetSize (uint32_t id) const
+{
+  return m_sizes[GetRank (id)];
+}
+
+} // namespace ns3
@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef WEB_OBJECT_CATALOG_H
+#define WEB_OBJECT_CATALOG_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include <vector>
+
+namespace ns3 {
+
+class RandomVariableStream;
+
+/**
+ * \ingroup applications
+ *
+ * \brief The objects a web server serves: a size per object and a Zipf
+ * popularity over them
+ *
+ * The object of popularity rank k (0 the most requested) is asked for with
+ * probability proportional to 1/(k+1)^alpha and has the id
+ * IdOffset + k*IdStride, so the catalogs of several servers share one id
+ * space: with one catalog per server, offset the server index and stride
+ * the number of servers, id modulo the number of servers is the server
+ * (what TcpWebProxy routes misses by).
+ *
+ * The size of every object is drawn once by Build from the secondary reply
+ * distribution, so repeated requests of an object get the same response
+ * size.  The sizes are the only per object state, one array of 4 bytes per
+ * object shared by all the browsers and the server of the catalog.
+ * Popularity ranks are sampled by rejection-inversion (Hoermann and
+ * Derflinger), in constant time and memory whatever the catalog size,
+ * instead of searching a table of the cumulative probabilities.
+ */
+class WebObjectCatalog : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  WebObjectCatalog ();
+
+  /**
+   * \param n objects
+   * \param alpha Zipf exponent (0 = every object equally popular)
+   * \param stream random variable stream of the object sizes
+   */
+  void Build (uint32_t n, double alpha, int64_t stream);
+
+  uint32_t GetNObjects (void) const;
+  double GetAlpha (void) const;
+  //bytes of per object state
+  uint64_t GetMemoryBytes (void) const;
+
+  /**
+   * \param uniform stream of uniform [0,1) samples, one or a few are used
+   * \return id of an object drawn by popularity
+   */
+  uint32_t Sample (Ptr<RandomVariableStream> uniform) const;
+  //whether id is an object of this catalog
+  bool Contains (uint32_t id) const;
+  //popularity rank of object id
+  uint32_t GetRank (uint32_t id) const;
+  uint32_t GetId (uint32_t rank) const;
+  //response size of object id (header of the response included)
+  uint32_t GetSize (uint32_t id) const;
+
+private:
+  double H (double x) const;
+  double HIntegral (double x) const;
+  double HIntegralInverse (double x) const;
+
+  uint32_t m_idOffset;
+  uint32_t m_idStride;
+  double m_alpha;
+  //rejection-inversion constants of the catalog size and alpha
+  double m_hIntegralX1;
+  double m_hIntegralN;
+  double m_s;
+  std::vector<uint32_t> m_sizes; //by rank
+};
+
+} // namespace ns3
+
+#endif /* WEB_OBJECT_CATALOG_H */
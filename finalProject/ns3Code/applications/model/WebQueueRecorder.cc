@@ -0,0 +1,353 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebQueueRecorder.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/red-queue.h"
+#include "ns3/codel-queue.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WebQueueRecorder");
+
+NS_OBJECT_ENSURE_REGISTERED (WebQueueRecorder);
+
+TypeId
+WebQueueRecorder::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WebQueueRecorder")
+    .SetParent<Object> ()
+    .SetGroupName("Applications")
+    .AddConstructor<WebQueueRecorder> ()
+    .AddAttribute ("BufferSize",
+                   "Records buffered before they are written",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&WebQueueRecorder::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("AverageWeight",
+                   "Weight of a new byte count in the averaged queue length",
+                   DoubleValue (0.002),
+                   MakeDoubleAccessor (&WebQueueRecorder::m_averageWeight),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("SampleInterval",
+                   "Record the queue every interval instead of on every enqueue/dequeue "
+                   "(0 records every event; drops are always recorded)",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&WebQueueRecorder::m_sampleInterval),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+WebQueueRecorder::WebQueueRecorder ()
+  : m_bytes (0),
+    m_packets (0),
+    m_averageBytes (0),
+    m_maxBytes (0),
+    m_enqueues (0),
+    m_dequeues (0),
+    m_earlyDrops (0),
+    m_forcedDrops (0),
+    m_lastUnforcedDrops (0),
+    m_byteSeconds (0),
+    m_used (0),
+    m_writer (0),
+    m_table (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+WebQueueRecorder::~WebQueueRecorder ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+WebQueueRecorder::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_sampleEvent);
+  Close ();
+  m_queue = 0;
+  m_queued.clear ();
+  Object::DoDispose ();
+}
+
+void
+WebQueueRecorder::Attach (Ptr<Queue> queue)
+{
+  NS_LOG_FUNCTION (this << queue);
+  m_queue = queue;
+  m_bytes = queue->GetNBytes ();
+  m_packets = queue->GetNPackets ();
+  m_maxBytes = m_bytes;
+  m_start = Simulator::Now ();
+  m_lastChange = m_start;
+  Ptr<RedQueue> red = DynamicCast<RedQueue> (queue);
+  if (red)
+    {
+      m_lastUnforcedDrops = red->GetStats ().unforcedDrop;
+    }
+  queue->TraceConnectWithoutContext ("Enqueue", MakeCallback (&WebQueueRecorder::NotifyEnqueue, this));
+  queue->TraceConnectWithoutContext ("Dequeue", MakeCallback (&WebQueueRecorder::NotifyDequeue, this));
+  queue->TraceConnectWithoutContext ("Drop", MakeCallback (&WebQueueRecorder::NotifyDrop, this));
+}
+
+bool
+WebQueueRecorder::Open (const std::string &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  m_writer = new WebResultWriter (m_bufferSize);
+  if (!m_writer->Open (filename))
+    {
+      delete m_writer;
+      m_writer = 0;
+      return false;
+    }
+  if (m_queue)
+    {
+      m_writer->SetConfig ("queueType", m_queue->GetInstanceTypeId ().GetName ());
+    }
+  m_writer->SetConfig ("sampleInterval", m_sampleInterval.GetSeconds () > 0 ? "periodic" : "every event");
+  m_table = m_writer->AddTable ("queue");
+  m_writer->AddColumn (m_table, "time", WebResultFile::TIME);
+  m_writer->AddColumn (m_table, "event", WebResultFile::UINT64);
+  m_writer->AddColumn (m_table, "bytes", WebResultFile::UINT64);
+  m_writer->AddColumn (m_table, "packets", WebResultFile::UINT64);
+  m_writer->AddColumn (m_table, "averageBytes", WebResultFile::DOUBLE);
+  m_buffer.resize (m_bufferSize);
+  m_used = 0;
+  if (m_sampleInterval.GetSeconds () > 0)
+    {
+      m_sampleEvent = Simulator::Schedule (m_sampleInterval, &WebQueueRecorder::Sample, this);
+    }
+  return true;
+}
+
+void
+WebQueueRecorder::Flush (void)
+{
+  if (!m_writer)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_used; i++)
+    {
+      const Record &r = m_buffer[i];
+      m_writer->AddTime (m_table, 0, r.time / 1e9);
+      m_writer->AddUint64 (m_table, 1, r.event);
+      m_writer->AddUint64 (m_table, 2, r.bytes);
+      m_writer->AddUint64 (m_table, 3, r.packets);
+      m_writer->AddDouble (m_table, 4, r.averageBytes);
+      m_writer->EndRow (m_table);
+    }
+  m_used = 0;
+}
+
+void
+WebQueueRecorder::Close (void)
+{
+  if (!m_writer)
+    {
+      return;
+    }
+  Flush ();
+  m_writer->Close ();
+  delete m_writer;
+  m_writer = 0;
+  Simulator::Cancel (m_sampleEvent);
+}
+
+void
+WebQueueRecorder::Add (EventType event)
+{
+  if (!m_writer)
+    {
+      return;
+    }
+  Record &r = m_buffer[m_used++];
+  r.time = Simulator::Now ().GetNanoSeconds ();
+  r.event = event;
+  r.bytes = m_bytes;
+  r.packets = m_packets;
+  r.averageBytes = m_averageBytes;
+  if (m_used == m_buffer.size ())
+    {
+      Flush ();
+    }
+}
+
+void
+WebQueueRecorder::Integrate (void)
+{
+  Time now = Simulator::Now ();
+  m_byteSeconds += m_bytes * (now - m_lastChange).GetSeconds ();
+  m_lastChange = now;
+}
+
+void
+WebQueueRecorder::NotifyEnqueue (Ptr<const Packet> packet)
+{
+  //the queue's own counters are updated after this trace, so keep our own
+  Integrate ();
+  m_bytes += packet->GetSize ();
+  m_packets++;
+  m_enqueues++;
+  m_queued.push_back (PeekPointer (packet));
+  if (m_bytes > m_maxBytes)
+    {
+      m_maxBytes = m_bytes;
+    }
+  m_averageBytes = (1 - m_averageWeight) * m_averageBytes + m_averageWeight * m_bytes;
+  if (m_sampleInterval.IsZero ())
+    {
+      Add (ENQUEUE);
+    }
+}
+
+void
+WebQueueRecorder::Remove (Ptr<const Packet> packet)
+{
+  NS_ABORT_MSG_IF (m_packets == 0 || m_bytes < packet->GetSize (),
+                   "queue occupancy below zero: " << m_packets << " packets, " << m_bytes
+                   << " bytes, " << packet->GetSize () << " bytes leave");
+  Integrate ();
+  m_bytes -= packet->GetSize ();
+  m_packets--;
+  if (!m_queued.empty () && m_queued.front () == PeekPointer (packet))
+    {
+      m_queued.pop_front ();
+    }
+}
+
+void
+WebQueueRecorder::NotifyDequeue (Ptr<const Packet> packet)
+{
+  Remove (packet);
+  m_dequeues++;
+  if (m_sampleInterval.IsZero ())
+    {
+      Add (DEQUEUE);
+    }
+}
+
+void
+WebQueueRecorder::NotifyDrop (Ptr<const Packet> packet)
+{
+  //only a packet that was queued can be the head of the queue; every other drop is an arrival
+  bool queued = !m_queued.empty () && m_queued.front () == PeekPointer (packet);
+  bool early = false;
+  Ptr<RedQueue> red = DynamicCast<RedQueue> (m_queue);
+  if (red)
+    {
+      //RedQueue counts the drop in its statistics before the Drop trace fires
+      uint32_t unforced = red->GetStats ().unforcedDrop;
+      early = unforced != m_lastUnforcedDrops;
+      m_lastUnforcedDrops = unforced;
+    }
+  if (DynamicCast<CoDelQueue> (m_queue))
+    {
+      //CoDel drops queued packets while it dequeues and arrivals only when it is full
+      early = queued;
+    }
+  if (queued)
+    {
+      Remove (packet);
+    }
+  if (early)
+    {
+      m_earlyDrops++;
+    }
+  else
+    {
+      m_forcedDrops++;
+    }
+  Add (early ? EARLY_DROP : FORCED_DROP);
+}
+
+void
+WebQueueRecorder::Sample (void)
+{
+  Add (SAMPLE);
+  m_sampleEvent = Simulator::Schedule (m_sampleInterval, &WebQueueRecorder::Sample, this);
+}
+
+uint64_t
+WebQueueRecorder::GetEnqueues (void) const
+{
+  return m_enqueues;
+}
+
+uint64_t
+WebQueueRecorder::GetDequeues (void) const
+{
+  return m_dequeues;
+}
+
+uint64_t
+WebQueueRecorder::GetEarlyDrops (void) const
+{
+  return m_earlyDrops;
+}
+
+uint64_t
+WebQueueRecorder::GetForcedDrops (void) const
+{
+  return m_forcedDrops;
+}
+
+uint32_t
+WebQueueRecorder::GetMaxBytes (void) const
+{
+  return m_maxBytes;
+}
+
+uint32_t
+WebQueueRecorder::GetBytes (void) const
+{
+  return m_bytes;
+}
+
+uint32_t
+WebQueueRecorder::GetPackets (void) const
+{
+  return m_packets;
+}
+
+double
+WebQueueRecorder::GetTimeAverageBytes (void) const
+{
+  Time now = Simulator::Now ();
+  double elapsed = (now - m_start).GetSeconds ();
+  if (elapsed <= 0)
+    {
+      return m_bytes;
+    }
+  return (m_byteSeconds + m_bytes * (now - m_lastChange).GetSeconds ()) / elapsed;
+}
+
+double
+WebQueueRecorder::GetAverageBytes (void) const
+{
+  return m_averageBytes;
+}
+
+} // Namespace ns3
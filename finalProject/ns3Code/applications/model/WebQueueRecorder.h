@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WEB_QUEUE_RECORDER_H
+#define WEB_QUEUE_RECORDER_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/packet.h"
+#include "ns3/queue.h"
+#include "WebResultFile.h"
+#include <vector>
+#include <deque>
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Records the occupancy and the drops of one (bottleneck) queue
+ *
+ * Attach hooks the Enqueue, Dequeue and Drop traces of the queue.  The
+ * recorder keeps its own byte/packet count, an exponentially weighted average
+ * of the byte count updated on every arrival (AverageWeight, as RED's QW),
+ * the time average and totals.  Drops of a RedQueue are split into early
+ * (unforced) and forced (forced or queue limit) drops by the change of its
+ * statistics.  A drop is told apart by where it happens: the recorder
+ * mirrors the queued packets, so a dropped packet at their head was queued
+ * (CoDel dropping while it dequeues, an early drop) and any other one is an
+ * arrival (CoDel's full queue and every drop of other queues, forced).  Only
+ * queued drops leave the byte/packet count.
+ *
+ * After Open every event (or, with a SampleInterval, every sample plus every
+ * drop) is written into a preallocated buffer of BufferSize records
+ * that is handed in one batch to a WebResultFile table "queue" when it is
+ * full.  Without Open only the totals are kept.
+ */
+class WebQueueRecorder : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  WebQueueRecorder ();
+  virtual ~WebQueueRecorder ();
+
+  //event column of the recorded table
+  enum EventType
+  {
+    ENQUEUE = 0,
+    DEQUEUE = 1,
+    EARLY_DROP = 2,
+    FORCED_DROP = 3,
+    SAMPLE = 5
+  };
+
+  /**
+   * Connect to the traces of a queue, call before packets are queued
+   */
+  void Attach (Ptr<Queue> queue);
+
+  /**
+   * Record events to a WebResultFile
+   * \return false if the file cannot be opened
+   */
+  bool Open (const std::string &filename);
+  //writes the buffered records
+  void Flush (void);
+  //writes the buffered records and the end of the file
+  void Close (void);
+
+  uint64_t GetEnqueues (void) const;
+  uint64_t GetDequeues (void) const;
+  uint64_t GetEarlyDrops (void) const;
+  uint64_t GetForcedDrops (void) const;
+  uint32_t GetMaxBytes (void) const;
+  //current byte and packet count
+  uint32_t GetBytes (void) const;
+  uint32_t GetPackets (void) const;
+  //time average of the byte count since Attach
+  double GetTimeAverageBytes (void) const;
+  //current exponentially weighted average of the byte count
+  double GetAverageBytes (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  typedef struct
+  {
+    int64_t time; //nanoseconds
+    uint8_t event;
+    uint32_t bytes;
+    uint32_t packets;
+    double averageBytes;
+  } Record;
+
+  void NotifyEnqueue (Ptr<const Packet> packet);
+  void NotifyDequeue (Ptr<const Packet> packet);
+  void NotifyDrop (Ptr<const Packet> packet);
+  void Sample (void);
+  //adds the byte count since the last change to the time integral
+  void Integrate (void);
+  //takes a packet that left the queue out of the byte/packet count
+  void Remove (Ptr<const Packet> packet);
+  void Add (EventType event);
+
+  Ptr<Queue> m_queue;
+  uint32_t m_bufferSize;
+  double m_averageWeight;
+  Time m_sampleInterval; //0: record every event
+
+  uint32_t m_bytes;
+  uint32_t m_packets;
+  double m_averageBytes;
+  uint32_t m_maxBytes;
+  uint64_t m_enqueues;
+  uint64_t m_dequeues;
+  uint64_t m_earlyDrops;
+  uint64_t m_forcedDrops;
+  uint32_t m_lastUnforcedDrops; //RedQueue statistics at the previous drop
+  std::deque<const Packet *> m_queued; //packets enqueued and not yet dequeued or dropped, head first
+  Time m_start;
+  Time m_lastChange;
+  double m_byteSeconds;
+
+  std::vector<Record> m_buffer;
+  uint32_t m_used;
+  WebResultWriter *m_writer;
+  uint32_t m_table;
+  EventId m_sampleEvent;
+};
+
+} // namespace ns3
+
+#endif /* WEB_QUEUE_RECORDER_H */
@@ -0,0 +1,196 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebRequestHeader.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (WebRequestHeader);
+
+const uint32_t WebRequestHeader::SIZE;
+const uint32_t WebRequestHeader::MAX_SIZE;
+const uint32_t WebRequestHeader::NO_OBJECT;
+const uint8_t WebRequestHeader::NO_CONTENT_TYPE;
+
+//set in the request size field when the object id follows
+static const uint32_t OBJECT_ID_FLAG = 0x80000000;
+//content type + 1 in the request size field, 0 for an uncompressed response
+static const uint32_t CONTENT_TYPE_MASK = 0x70000000;
+static const uint32_t CONTENT_TYPE_SHIFT = 28;
+static const uint32_t REQUEST_SIZE_MASK = 0x0fffffff;
+
+static uint8_t
+DecodeContentType (uint32_t requestSize)
+{
+  uint32_t t = (requestSize & CONTENT_TYPE_MASK) >> CONTENT_TYPE_SHIFT;
+  return t == 0 ? WebRequestHeader::NO_CONTENT_TYPE : t - 1;
+}
+
+static uint32_t
+ReadU32 (const uint8_t *bytes)
+{
+  return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16)
+    | ((uint32_t)bytes[2] << 8) | (uint32_t)bytes[3];
+}
+
+WebRequestHeader::WebRequestHeader ()
+  : m_requestSize (SIZE),
+    m_responseSize (0),
+    m_objectId (NO_OBJECT),
+    m_contentType (NO_CONTENT_TYPE)
+{
+}
+
+void
+WebRequestHeader::SetRequestSize (uint32_t size)
+{
+  m_requestSize = size;
+}
+
+uint32_t
+WebRequestHeader::GetRequestSize (void) const
+{
+  return m_requestSize;
+}
+
+void
+WebRequestHeader::SetResponseSize (uint32_t size)
+{
+  m_responseSize = size;
+}
+
+uint32_t
+WebRequestHeader::GetResponseSize (void) const
+{
+  return m_responseSize;
+}
+
+void
+WebRequestHeader::SetObjectId (uint32_t id)
+{
+  m_objectId = id;
+}
+
+uint32_t
+WebRequestHeader::GetObjectId (void) const
+{
+  return m_objectId;
+}
+
+bool
+WebRequestHeader::HasObjectId (void) const
+{
+  return m_objectId != NO_OBJECT;
+}
+
+void
+WebRequestHeader::SetContentType (uint8_t type)
+{
+  NS_ASSERT (type == NO_CONTENT_TYPE || type < (CONTENT_TYPE_MASK >> CONTENT_TYPE_SHIFT));
+  m_contentType = type;
+}
+
+uint8_t
+WebRequestHeader::GetContentType (void) const
+{
+  return m_contentType;
+}
+
+bool
+WebRequestHeader::HasContentType (void) const
+{
+  return m_contentType != NO_CONTENT_TYPE;
+}
+
+//the request size field with the flags of the object id and the content type
+static uint32_t
+EncodeRequestSize (uint32_t size, bool objectId, uint8_t type)
+{
+  NS_ASSERT (size <= REQUEST_SIZE_MASK);
+  uint32_t t = type == WebRequestHeader::NO_CONTENT_TYPE ? 0 : type + 1;
+  return size | (objectId ? OBJECT_ID_FLAG : 0) | (t << CONTENT_TYPE_SHIFT);
+}
+
+void
+WebRequestHeader::DeserializeBytes (const uint8_t *bytes)
+{
+  uint32_t requestSize = ReadU32 (bytes);
+  m_requestSize = requestSize & REQUEST_SIZE_MASK;
+  m_contentType = DecodeContentType (requestSize);
+  m_responseSize = ReadU32 (bytes + 4);
+  m_objectId = (requestSize & OBJECT_ID_FLAG) ? ReadU32 (bytes + 8) : NO_OBJECT;
+}
+
+TypeId
+WebRequestHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WebRequestHeader")
+    .SetParent<Header> ()
+    .SetGroupName("Applications")
+    .AddConstructor<WebRequestHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+WebRequestHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+WebRequestHeader::Print (std::ostream &os) const
+{
+  os << "request=" << m_requestSize << " response=" << m_responseSize;
+  if (HasObjectId ())
+    {
+      os << " object=" << m_objectId;
+    }
+  if (HasContentType ())
+    {
+      os << " type=" << (uint32_t)m_contentType;
+    }
+}
+
+uint32_t
+WebRequestHeader::GetSerializedSize (void) const
+{
+  return HasObjectId () ? MAX_SIZE : SIZE;
+}
+
+void
+WebRequestHeader::Serialize (Buffer::Iterator start) const
+{
+  start.WriteHtonU32 (EncodeRequestSize (m_requestSize, HasObjectId (), m_contentType));
+  start.WriteHtonU32 (m_responseSize);
+  if (HasObjectId ())
+    {
+      start.WriteHtonU32 (m_objectId);
+    }
+}
+
+uint32_t
+WebRequestHeader::Deserialize (Buffer::Iterator start)
+{
+  uint32_t requestSize = start.ReadNtohU32 ();
+  m_requestSize = requestSize & REQUEST_SIZE_MASK;
+  m_contentType = DecodeContentType (requestSize);
+  m_responseSize = start.ReadNtohU32 ();
+  m_objectId = (requestSize & OBJECT_ID_FLAG) ? start.ReadNtohU32 () : NO_OBJECT;
+  return GetSerializedSize ();
+}
+
+} // namespace ns3
@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef WEB_REQUEST_HEADER_H
+#define WEB_REQUEST_HEADER_H
+
+#include "ns3/header.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Header of a TcpWebClient request
+ *
+ * The request size (header included) then the size of the response asked
+ * for, 4 bytes each in network order, optionally followed by the id of the
+ * object asked for (TcpWebClient with a WebObjectCatalog).  The top bit of
+ * the request size tells whether the id is there, so requests without one
+ * keep their 8 byte header.  The three bits below it carry the content type
+ * of a response the client accepts compressed (WebCompressionModel), zero
+ * when it wants the response as is.  The rest of the request is padding:
+ * TcpWebClient adds the header to a zero filled Packet, so no payload
+ * buffer exists behind it.  TcpWebServer and TcpWebProxy see the request in
+ * segments and decode the header from its first bytes with DeserializeBytes.
+ */
+class WebRequestHeader : public Header
+{
+public:
+  static const uint32_t SIZE = 8;
+  //with the object id
+  static const uint32_t MAX_SIZE = 12;
+  //object id of a request without one
+  static const uint32_t NO_OBJECT = 0xffffffff;
+  //content type of a request for an uncompressed response
+  static const uint8_t NO_CONTENT_TYPE = 0xff;
+
+  WebRequestHeader ();
+
+  void SetRequestSize (uint32_t size);
+  uint32_t GetRequestSize (void) const;
+  void SetResponseSize (uint32_t size);
+  uint32_t GetResponseSize (void) const;
+  void SetObjectId (uint32_t id);
+  uint32_t GetObjectId (void) const;
+  bool HasObjectId (void) const;
+  //type 0 to 6 of a response that may be compressed
+  void SetContentType (uint8_t type);
+  uint8_t GetContentType (void) const;
+  bool HasContentType (void) const;
+
+  /**
+   * \param bytes the first SIZE bytes of a request, MAX_SIZE if it carries
+   *        an object id
+   */
+  void DeserializeBytes (const uint8_t *bytes);
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  uint32_t m_requestSize;
+  uint32_t m_responseSize;
+  uint32_t m_objectId;
+  uint8_t m_contentType;
+};
+
+} // namespace ns3
+
+#endif /* WEB_REQUEST_HEADER_H */
@@ -0,0 +1,236 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebResponseHistogram.h"
+
+#include <cmath>
+#include <string>
+
+namespace ns3 {
+
+const uint32_t WebResponseHistogram::SUB_BITS;
+
+WebResponseHistogram::WebResponseHistogram ()
+  : m_count (0),
+    m_sum (0),
+    m_min (0),
+    m_max (0)
+{
+}
+
+uint32_t
+WebResponseHistogram::BucketIndex (uint64_t micros)
+{
+  if (micros < (1ULL << SUB_BITS))
+    {
+      return (uint32_t)micros;
+    }
+  uint32_t msb = 0;
+  for (uint64_t v = micros; v > 1; v >>= 1)
+    {
+      msb++;
+    }
+  uint32_t shift = msb - SUB_BITS;
+  uint64_t mantissa = micros >> shift;
+  return ((shift + 1) << SUB_BITS) + (uint32_t)(mantissa - (1ULL << SUB_BITS));
+}
+
+uint64_t
+WebResponseHistogram::BucketUpperEdge (uint32_t index)
+{
+  if (index < (1U << SUB_BITS))
+    {
+      return index;
+    }
+  uint32_t shift = (index >> SUB_BITS) - 1;
+  uint64_t mantissa = (index & ((1U << SUB_BITS) - 1)) + (1ULL << SUB_BITS);
+  return ((mantissa + 1) << shift) - 1;
+}
+
+void
+WebResponseHistogram::Record (double seconds)
+{
+  if (seconds < 0)
+    {
+      seconds = 0;
+    }
+  uint32_t index = BucketIndex ((uint64_t)(seconds * 1e6 + 0.5));
+  if (index >= m_counts.size ())
+    {
+      m_counts.resize (index + 1, 0);
+    }
+  m_counts[index]++;
+  if (m_count == 0 || seconds < m_min)
+    {
+      m_min = seconds;
+    }
+  if (m_count == 0 || seconds > m_max)
+    {
+      m_max = seconds;
+    }
+  m_count++;
+  m_sum += seconds;
+}
+
+void
+WebResponseHistogram::Merge (const WebResponseHistogram &other)
+{
+  if (other.m_count == 0)
+    {
+      return;
+    }
+  if (other.m_counts.size () > m_counts.size ())
+    {
+      m_counts.resize (other.m_counts.size (), 0);
+    }
+  for (uint32_t i = 0; i < other.m_counts.size (); i++)
+    {
+      m_counts[i] += other.m_counts[i];
+    }
+  if (m_count == 0 || other.m_min < m_min)
+    {
+      m_min = other.m_min;
+    }
+  if (m_count == 0 || other.m_max > m_max)
+    {
+      m_max = other.m_max;
+    }
+  m_count += other.m_count;
+  m_sum += other.m_sum;
+}
+
+uint64_t
+WebResponseHistogram::GetCount (void) const
+{
+  return m_count;
+}
+
+double
+WebResponseHistogram::GetMean (void) const
+{
+  return m_count ? m_sum / m_count : 0.0;
+}
+
+double
+WebResponseHistogram::GetMin (void) const
+{
+  return m_min;
+}
+
+double
+WebResponseHistogram::GetMax (void) const
+{
+  return m_max;
+}
+
+double
+WebResponseHistogram::GetQuantile (double q) const
+{
+  if (m_count == 0)
+    {
+      return 0.0;
+    }
+  uint64_t rank = (uint64_t)std::ceil (q * m_count);
+  if (rank == 0)
+    {
+      return m_min;
+    }
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < m_counts.size (); i++)
+    {
+      seen += m_counts[i];
+      if (seen >= rank)
+        {
+          double value = BucketUpperEdge (i) / 1e6;
+          return value > m_max ? m_max : value;
+        }
+    }
+  return m_max;
+}
+
+std::vector<WebResponseHistogram::CdfPoint>
+WebResponseHistogram::GetCdf (void) const
+{
+  std::vector<CdfPoint> cdf;
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < m_counts.size (); i++)
+    {
+      if (m_counts[i] == 0)
+        {
+          continue;
+        }
+      seen += m_counts[i];
+      CdfPoint p;
+      p.value = BucketUpperEdge (i) / 1e6;
+      if (p.value > m_max)
+        {
+          p.value = m_max;
+        }
+      p.cumulative = (double)seen / m_count;
+      cdf.push_back (p);
+    }
+  return cdf;
+}
+
+void
+WebResponseHistogram::Serialize (std::ostream &os) const
+{
+  uint32_t nonEmpty = 0;
+  for (uint32_t i = 0; i < m_counts.size (); i++)
+    {
+      nonEmpty += m_counts[i] ? 1 : 0;
+    }
+  std::streamsize precision = os.precision (17);
+  os << "histogram " << m_count << " " << m_sum << " " << m_min << " " << m_max << " " << nonEmpty;
+  for (uint32_t i = 0; i < m_counts.size (); i++)
+    {
+      if (m_counts[i])
+        {
+          os << " " << i << ":" << m_counts[i];
+        }
+    }
+  os << std::endl;
+  os.precision (precision);
+}
+
+bool
+WebResponseHistogram::Deserialize (std::istream &is)
+{
+  std::string tag;
+  uint32_t nonEmpty;
+  if (!(is >> tag) || tag != "histogram" || !(is >> m_count >> m_sum >> m_min >> m_max >> nonEmpty))
+    {
+      return false;
+    }
+  m_counts.clear ();
+  for (uint32_t i = 0; i < nonEmpty; i++)
+    {
+      uint32_t index;
+      uint64_t count;
+      char colon;
+      if (!(is >> index >> colon >> count))
+        {
+          return false;
+        }
+      if (index >= m_counts.size ())
+        {
+          m_counts.resize (index + 1, 0);
+        }
+      m_counts[index] = count;
+    }
+  return true;
+}
+
+} // Namespace ns3
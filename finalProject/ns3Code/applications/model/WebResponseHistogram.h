@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WEB_RESPONSE_HISTOGRAM_H
+#define WEB_RESPONSE_HISTOGRAM_H
+
+#include <stdint.h>
+#include <vector>
+#include <istream>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Mergeable log-linear histogram of response times (HDR histogram layout)
+ *
+ * Values are recorded in microseconds.  Below 2^SUB_BITS us every value has
+ * its own bucket; above, every power of two is split into 2^SUB_BITS linear
+ * buckets, so any quantile is reported with a relative error below
+ * 2^-SUB_BITS (under 1%) whatever the number of samples.  Memory only grows
+ * with the range of the values, never with their count, and two histograms
+ * are merged by adding their buckets.
+ */
+class WebResponseHistogram
+{
+public:
+  WebResponseHistogram ();
+
+  /**
+   * \param seconds response time to add
+   */
+  void Record (double seconds);
+
+  /**
+   * Add every sample of another histogram to this one
+   */
+  void Merge (const WebResponseHistogram &other);
+
+  uint64_t GetCount (void) const;
+  //all in seconds
+  double GetMean (void) const;
+  double GetMin (void) const;
+  double GetMax (void) const;
+
+  /**
+   * \param q quantile in [0,1]
+   * \return value (seconds) below or at which a fraction q of the samples lie
+   */
+  double GetQuantile (double q) const;
+
+  //one step of the empirical CDF: upper edge of a bucket and the fraction of samples up to it
+  typedef struct
+  {
+    double value;
+    double cumulative;
+  } CdfPoint;
+
+  /**
+   * \return one point per non empty bucket, in increasing order
+   */
+  std::vector<CdfPoint> GetCdf (void) const;
+
+  /**
+   * Write the histogram as one text line that Deserialize reads back
+   * (used to hand histograms from child processes to their parent)
+   */
+  void Serialize (std::ostream &os) const;
+  bool Deserialize (std::istream &is);
+
+  //linear buckets per power of two (relative error 2^-SUB_BITS)
+  static const uint32_t SUB_BITS = 7;
+
+private:
+  static uint32_t BucketIndex (uint64_t micros);
+  static uint64_t BucketUpperEdge (uint32_t index);
+
+  std::vector<uint64_t> m_counts;
+  uint64_t m_count;
+  double m_sum;
+  double m_min;
+  double m_max;
+};
+
+} // namespace ns3
+
+#endif /* WEB_RESPONSE_HISTOGRAM_H */
@@ -0,0 +1,537 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebResultFile.h"
+#include "ns3/abort.h"
+
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace ns3 {
+
+const char WebResultFile::MAGIC[8] = { 'N', 'S', '3', 'W', 'E', 'B', 'R', '1' };
+
+void
+WebResultFile::PutVarint (std::string &buf, uint64_t v)
+{
+  while (v >= 0x80)
+    {
+      buf.push_back ((char)((v & 0x7f) | 0x80));
+      v >>= 7;
+    }
+  buf.push_back ((char)v);
+}
+
+bool
+WebResultFile::GetVarint (const std::string &buf, uint32_t &pos, uint64_t &v)
+{
+  v = 0;
+  for (uint32_t shift = 0; shift < 64 && pos < buf.size (); shift += 7)
+    {
+      uint8_t b = (uint8_t)buf[pos++];
+      v |= (uint64_t)(b & 0x7f) << shift;
+      if (!(b & 0x80))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+uint64_t
+WebResultFile::EncodeDouble (double v)
+{
+  uint64_t bits;
+  std::memcpy (&bits, &v, sizeof (bits));
+  return bits;
+}
+
+double
+WebResultFile::DecodeDouble (uint64_t bits)
+{
+  double v;
+  std::memcpy (&v, &bits, sizeof (v));
+  return v;
+}
+
+uint64_t
+WebResultFile::EncodeTime (double seconds)
+{
+  return (uint64_t)(int64_t)std::floor (seconds * 1e9 + 0.5);
+}
+
+void
+WebResultFile::EncodeColumn (ColumnType type, const std::vector<uint64_t> &values, std::string &out)
+{
+  uint64_t prev = 0;
+  for (uint32_t i = 0; i < values.size (); i++)
+    {
+      if (type == DOUBLE)
+        {
+          PutVarint (out, values[i] ^ prev);
+        }
+      else
+        {
+          int64_t delta = (int64_t)(values[i] - prev);
+          PutVarint (out, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+        }
+      prev = values[i];
+    }
+}
+
+bool
+WebResultFile::DecodeColumn (ColumnType type, const std::string &in, uint32_t rows, std::vector<uint64_t> &values)
+{
+  uint64_t prev = 0;
+  uint32_t pos = 0;
+  for (uint32_t i = 0; i < rows; i++)
+    {
+      uint64_t v;
+      if (!GetVarint (in, pos, v))
+        {
+          return false;
+        }
+      if (type == DOUBLE)
+        {
+          prev ^= v;
+        }
+      else
+        {
+          prev += (v >> 1) ^ (~(v & 1) + 1);
+        }
+      values.push_back (prev);
+    }
+  return pos == in.size ();
+}
+
+WebResultWriter::WebResultWriter (uint32_t blockRows)
+  : m_blockRows (blockRows)
+{
+}
+
+WebResultWriter::~WebResultWriter ()
+{
+  Close ();
+}
+
+bool
+WebResultWriter::Open (const std::string &filename)
+{
+  m_file.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_file.is_open ())
+    {
+      return false;
+    }
+  m_file.write (WebResultFile::MAGIC, sizeof (WebResultFile::MAGIC));
+  return true;
+}
+
+void
+WebResultWriter::Close (void)
+{
+  if (!m_file.is_open ())
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_tables.size (); i++)
+    {
+      DeclareTable (i);
+      FlushTable (i);
+    }
+  m_file.put ('E');
+  m_file.close ();
+}
+
+void
+WebResultWriter::PutU32 (uint32_t v)
+{
+  char b[4] = { (char)v, (char)(v >> 8), (char)(v >> 16), (char)(v >> 24) };
+  m_file.write (b, 4);
+}
+
+void
+WebResultWriter::PutString (const std::string &s)
+{
+  PutU32 (s.size ());
+  m_file.write (s.data (), s.size ());
+}
+
+void
+WebResultWriter::SetConfig (const std::string &key, const std::string &value)
+{
+  NS_ABORT_MSG_IF (!m_file.is_open (), "WebResultWriter: SetConfig before Open");
+  m_file.put ('C');
+  PutString (key);
+  PutString (value);
+}
+
+uint32_t
+WebResultWriter::AddTable (const std::string &name)
+{
+  Table t;
+  t.name = name;
+  t.rows = 0;
+  t.declared = false;
+  m_tables.push_back (t);
+  return m_tables.size () - 1;
+}
+
+uint32_t
+WebResultWriter::AddColumn (uint32_t table, const std::string &name, WebResultFile::ColumnType type)
+{
+  NS_ABORT_MSG_IF (table >= m_tables.size (), "WebResultWriter: no table " << table);
+  NS_ABORT_MSG_IF (m_tables[table].declared, "WebResultWriter: columns of " << m_tables[table].name << " added after its first row");
+  Column c;
+  c.name = name;
+  c.type = type;
+  m_tables[table].columns.push_back (c);
+  return m_tables[table].columns.size () - 1;
+}
+
+void
+WebResultWriter::Add (uint32_t table, uint32_t column, WebResultFile::ColumnType type, uint64_t v)
+{
+  NS_ABORT_MSG_IF (table >= m_tables.size () || column >= m_tables[table].columns.size (),
+                   "WebResultWriter: no column " << column << " in table " << table);
+  Column &c = m_tables[table].columns[column];
+  NS_ABORT_MSG_IF (c.type != type, "WebResultWriter: wrong type for column " << c.name);
+  NS_ABORT_MSG_IF (c.values.size () != m_tables[table].rows, "WebResultWriter: column " << c.name << " set twice in one row");
+  c.values.push_back (v);
+}
+
+void
+WebResultWriter::AddUint64 (uint32_t table, uint32_t column, uint64_t v)
+{
+  Add (table, column, WebResultFile::UINT64, v);
+}
+
+void
+WebResultWriter::AddInt64 (uint32_t table, uint32_t column, int64_t v)
+{
+  Add (table, column, WebResultFile::INT64, (uint64_t)v);
+}
+
+void
+WebResultWriter::AddDouble (uint32_t table, uint32_t column, double v)
+{
+  Add (table, column, WebResultFile::DOUBLE, WebResultFile::EncodeDouble (v));
+}
+
+void
+WebResultWriter::AddTime (uint32_t table, uint32_t column, double seconds)
+{
+  Add (table, column, WebResultFile::TIME, WebResultFile::EncodeTime (seconds));
+}
+
+void
+WebResultWriter::EndRow (uint32_t table)
+{
+  Table &t = m_tables[table];
+  for (uint32_t i = 0; i < t.columns.size (); i++)
+    {
+      NS_ABORT_MSG_IF (t.columns[i].values.size () != t.rows + 1,
+                       "WebResultWriter: column " << t.columns[i].name << " missing in row of " << t.name);
+    }
+  DeclareTable (table);
+  t.rows++;
+  if (t.rows >= m_blockRows)
+    {
+      FlushTable (table);
+    }
+}
+
+void
+WebResultWriter::DeclareTable (uint32_t table)
+{
+  Table &t = m_tables[table];
+  if (t.declared)
+    {
+      return;
+    }
+  m_file.put ('T');
+  PutU32 (table);
+  PutString (t.name);
+  PutU32 (t.columns.size ());
+  for (uint32_t i = 0; i < t.columns.size (); i++)
+    {
+      PutString (t.columns[i].name);
+      m_file.put ((char)t.columns[i].type);
+    }
+  t.declared = true;
+}
+
+void
+WebResultWriter::FlushTable (uint32_t table)
+{
+  Table &t = m_tables[table];
+  if (t.rows == 0)
+    {
+      return;
+    }
+  m_file.put ('B');
+  PutU32 (table);
+  PutU32 (t.rows);
+  for (uint32_t i = 0; i < t.columns.size (); i++)
+    {
+      m_encoded.clear ();
+      WebResultFile::EncodeColumn (t.columns[i].type, t.columns[i].values, m_encoded);
+      PutString (m_encoded);
+      t.columns[i].values.clear ();
+    }
+  t.rows = 0;
+}
+
+WebResultReader::WebResultReader ()
+{
+}
+
+namespace {
+
+bool
+GetU32 (const std::string &buf, uint32_t &pos, uint32_t &v)
+{
+  if (pos + 4 > buf.size ())
+    {
+      return false;
+    }
+  v = (uint32_t)(uint8_t)buf[pos] | ((uint32_t)(uint8_t)buf[pos + 1] << 8)
+    | ((uint32_t)(uint8_t)buf[pos + 2] << 16) | ((uint32_t)(uint8_t)buf[pos + 3] << 24);
+  pos += 4;
+  return true;
+}
+
+bool
+GetString (const std::string &buf, uint32_t &pos, std::string &s)
+{
+  uint32_t len;
+  if (!GetU32 (buf, pos, len) || pos + len > buf.size ())
+    {
+      return false;
+    }
+  s = buf.substr (pos, len);
+  pos += len;
+  return true;
+}
+
+} // anonymous namespace
+
+bool
+WebResultReader::Open (const std::string &filename)
+{
+  m_config.clear ();
+  m_tables.clear ();
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  if (!file.is_open ())
+    {
+      return false;
+    }
+  std::string buf ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char> ());
+  if (buf.size () < sizeof (WebResultFile::MAGIC)
+      || buf.compare (0, sizeof (WebResultFile::MAGIC), WebResultFile::MAGIC, sizeof (WebResultFile::MAGIC)) != 0)
+    {
+      return false;
+    }
+  uint32_t pos = sizeof (WebResultFile::MAGIC);
+  while (pos < buf.size ())
+    {
+      char tag = buf[pos++];
+      if (tag == 'E')
+        {
+          return true;
+        }
+      else if (tag == 'C')
+        {
+          std::string key, value;
+          if (!GetString (buf, pos, key) || !GetString (buf, pos, value))
+            {
+              return false;
+            }
+          m_config.push_back (std::make_pair (key, value));
+        }
+      else if (tag == 'T')
+        {
+          uint32_t id, nColumns;
+          Table t;
+          if (!GetU32 (buf, pos, id) || !GetString (buf, pos, t.name) || !GetU32 (buf, pos, nColumns))
+            {
+              return false;
+            }
+          for (uint32_t i = 0; i < nColumns; i++)
+            {
+              Column c;
+              if (!GetString (buf, pos, c.name) || pos >= buf.size ())
+                {
+                  return false;
+                }
+              c.type = (WebResultFile::ColumnType)buf[pos++];
+              t.columns.push_back (c);
+            }
+          if (id >= m_tables.size ())
+            {
+              m_tables.resize (id + 1);
+            }
+          m_tables[id] = t;
+        }
+      else if (tag == 'B')
+        {
+          uint32_t id, rows;
+          if (!GetU32 (buf, pos, id) || !GetU32 (buf, pos, rows) || id >= m_tables.size ())
+            {
+              return false;
+            }
+          Table &t = m_tables[id];
+          for (uint32_t i = 0; i < t.columns.size (); i++)
+            {
+              std::string encoded;
+              if (!GetString (buf, pos, encoded)
+                  || !WebResultFile::DecodeColumn (t.columns[i].type, encoded, rows, t.columns[i].values))
+                {
+                  return false;
+                }
+            }
+        }
+      else
+        {
+          return false;
+        }
+    }
+  //no end record: the writer did not finish
+  return false;
+}
+
+uint32_t
+WebResultReader::GetNConfig (void) const
+{
+  return m_config.size ();
+}
+
+std::string
+WebResultReader::GetConfigKey (uint32_t i) const
+{
+  return m_config[i].first;
+}
+
+std::string
+WebResultReader::GetConfigValue (uint32_t i) const
+{
+  return m_config[i].second;
+}
+
+std::string
+WebResultReader::GetConfig (const std::string &key) const
+{
+  for (uint32_t i = 0; i < m_config.size (); i++)
+    {
+      if (m_config[i].first == key)
+        {
+          return m_config[i].second;
+        }
+    }
+  return "";
+}
+
+uint32_t
+WebResultReader::GetNTables (void) const
+{
+  return m_tables.size ();
+}
+
+std::string
+WebResultReader::GetTableName (uint32_t table) const
+{
+  return m_tables[table].name;
+}
+
+int32_t
+WebResultReader::FindTable (const std::string &name) const
+{
+  for (uint32_t i = 0; i < m_tables.size (); i++)
+    {
+      if (m_tables[i].name == name)
+        {
+          return i;
+        }
+    }
+  return -1;
+}
+
+uint32_t
+WebResultReader::GetNRows (uint32_t table) const
+{
+  return m_tables[table].columns.empty () ? 0 : m_tables[table].columns[0].values.size ();
+}
+
+uint32_t
+WebResultReader::GetNColumns (uint32_t table) const
+{
+  return m_tables[table].columns.size ();
+}
+
+std::string
+WebResultReader::GetColumnName (uint32_t table, uint32_t column) const
+{
+  return m_tables[table].columns[column].name;
+}
+
+WebResultFile::ColumnType
+WebResultReader::GetColumnType (uint32_t table, uint32_t column) const
+{
+  return m_tables[table].columns[column].type;
+}
+
+int32_t
+WebResultReader::FindColumn (uint32_t table, const std::string &name) const
+{
+  for (uint32_t i = 0; i < m_tables[table].columns.size (); i++)
+    {
+      if (m_tables[table].columns[i].name == name)
+        {
+          return i;
+        }
+    }
+  return -1;
+}
+
+uint64_t
+WebResultReader::GetUint64 (uint32_t table, uint32_t column, uint32_t row) const
+{
+  return m_tables[table].columns[column].values[row];
+}
+
+int64_t
+WebResultReader::GetInt64 (uint32_t table, uint32_t column, uint32_t row) const
+{
+  return (int64_t)m_tables[table].columns[column].values[row];
+}
+
+double
+WebResultReader::GetDouble (uint32_t table, uint32_t column, uint32_t row) const
+{
+  const Column &c = m_tables[table].columns[column];
+  switch (c.type)
+    {
+    case WebResultFile::UINT64:
+      return (double)c.values[row];
+    case WebResultFile::INT64:
+      return (double)(int64_t)c.values[row];
+    case WebResultFile::TIME:
+      return (int64_t)c.values[row] / 1e9;
+    default:
+      return WebResultFile::DecodeDouble (c.values[row]);
+    }
+}
+
+} // Namespace ns3
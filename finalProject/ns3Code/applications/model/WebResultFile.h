@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WEB_RESULT_FILE_H
+#define WEB_RESULT_FILE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Columnar binary result file (".wrb")
+ *
+ * A file holds key/value run configuration entries and any number of tables
+ * with typed columns.  Rows are buffered and written in blocks; inside a
+ * block every column is stored on its own:
+ *  - UINT64, INT64 and TIME (simulator nanoseconds): zigzag varint of the
+ *    difference to the previous value,
+ *  - DOUBLE: varint of the XOR with the previous value's bits.
+ * The blocks are not compressed any further: sorted and slowly changing
+ * columns already shrink to a byte or two per value, which is what a
+ * general purpose block compressor would mostly find, without making zlib a
+ * dependency of the module and of the python reader.
+ *
+ * Layout (all fixed width integers little endian, str = u32 length + bytes):
+ *  "NS3WEBR1", then records: 'C' str key, str value |
+ *  'T' u32 table, str name, u32 columns, (str name, u8 type)* |
+ *  'B' u32 table, u32 rows, (u32 bytes, encoded column)* | 'E' (end).
+ * finalProject/graphs/webResults.py reads the same format.
+ */
+class WebResultFile
+{
+public:
+  enum ColumnType
+  {
+    UINT64 = 0,
+    INT64 = 1,
+    DOUBLE = 2,
+    TIME = 3 //stored as int64 nanoseconds, read back in seconds
+  };
+
+  static const char MAGIC[8];
+
+  static void PutVarint (std::string &buf, uint64_t v);
+  static bool GetVarint (const std::string &buf, uint32_t &pos, uint64_t &v);
+  //column value as stored (doubles by their bits, times in nanoseconds)
+  static uint64_t EncodeDouble (double v);
+  static double DecodeDouble (uint64_t bits);
+  static uint64_t EncodeTime (double seconds);
+  static void EncodeColumn (ColumnType type, const std::vector<uint64_t> &values, std::string &out);
+  static bool DecodeColumn (ColumnType type, const std::string &in, uint32_t rows, std::vector<uint64_t> &values);
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Writes a WebResultFile
+ *
+ * Declare a table and its columns, then fill one value per column and call
+ * EndRow.  Close (or the destructor) writes the last blocks.
+ */
+class WebResultWriter
+{
+public:
+  /**
+   * \param blockRows rows buffered per table before a block is written
+   */
+  WebResultWriter (uint32_t blockRows = 65536);
+  ~WebResultWriter ();
+
+  bool Open (const std::string &filename);
+  void Close (void);
+
+  void SetConfig (const std::string &key, const std::string &value);
+
+  uint32_t AddTable (const std::string &name);
+  uint32_t AddColumn (uint32_t table, const std::string &name, WebResultFile::ColumnType type);
+
+  void AddUint64 (uint32_t table, uint32_t column, uint64_t v);
+  void AddInt64 (uint32_t table, uint32_t column, int64_t v);
+  void AddDouble (uint32_t table, uint32_t column, double v);
+  void AddTime (uint32_t table, uint32_t column, double seconds);
+  void EndRow (uint32_t table);
+
+private:
+  typedef struct
+  {
+    std::string name;
+    WebResultFile::ColumnType type;
+    std::vector<uint64_t> values;
+  } Column;
+  typedef struct
+  {
+    std::string name;
+    std::vector<Column> columns;
+    uint32_t rows;
+    bool declared; //'T' record written, columns are fixed
+  } Table;
+
+  void Add (uint32_t table, uint32_t column, WebResultFile::ColumnType type, uint64_t v);
+  void DeclareTable (uint32_t table);
+  void FlushTable (uint32_t table);
+  void PutU32 (uint32_t v);
+  void PutString (const std::string &s);
+
+  std::ofstream m_file;
+  std::vector<Table> m_tables;
+  uint32_t m_blockRows;
+  std::string m_encoded; //reused encode buffer
+};
+
+/**
+ * \ingroup applications
+ *
+ * \brief Reads a whole WebResultFile into memory
+ */
+class WebResultReader
+{
+public:
+  WebResultReader ();
+
+  /**
+   * \return false if the file cannot be read or is not a complete result file
+   */
+  bool Open (const std::string &filename);
+
+  uint32_t GetNConfig (void) const;
+  std::string GetConfigKey (uint32_t i) const;
+  std::string GetConfigValue (uint32_t i) const;
+  //"" if the key is missing
+  std::string GetConfig (const std::string &key) const;
+
+  uint32_t GetNTables (void) const;
+  std::string GetTableName (uint32_t table) const;
+  //-1 if there is no such table
+  int32_t FindTable (const std::string &name) const;
+  uint32_t GetNRows (uint32_t table) const;
+  uint32_t GetNColumns (uint32_t table) const;
+  std::string GetColumnName (uint32_t table, uint32_t column) const;
+  WebResultFile::ColumnType GetColumnType (uint32_t table, uint32_t column) const;
+  //-1 if there is no such column
+  int32_t FindColumn (uint32_t table, const std::string &name) const;
+
+  uint64_t GetUint64 (uint32_t table, uint32_t column, uint32_t row) const;
+  int64_t GetInt64 (uint32_t table, uint32_t column, uint32_t row) const;
+  //any column type converted to double (TIME in seconds)
+  double GetDouble (uint32_t table, uint32_t column, uint32_t row) const;
+
+private:
+  typedef struct
+  {
+    std::string name;
+    WebResultFile::ColumnType type;
+    std::vector<uint64_t> values;
+  } Column;
+  typedef struct
+  {
+    std::string name;
+    std::vector<Column> columns;
+  } Table;
+
+  std::vector<std::pair<std::string, std::string> > m_config;
+  std::vector<Table> m_tables;
+};
+
+} // namespace ns3
+
+#endif /* WEB_RESULT_FILE_H */
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebSocketPool.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/type-id.h"
+#include "ns3/node.h"
+#include "ns3/socket.h"
+#include "ns3/socket-factory.h"
+#include "ns3/tcp-socket-factory.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WebSocketPool");
+
+NS_OBJECT_ENSURE_REGISTERED (WebSocketPool);
+
+TypeId
+WebSocketPool::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WebSocketPool")
+    .SetParent<Object> ()
+    .SetGroupName("Applications")
+    .AddConstructor<WebSocketPool> ()
+    .AddAttribute ("SocketType", "The socket factory the sockets come from",
+                   TypeIdValue (TcpSocketFactory::GetTypeId ()),
+                   MakeTypeIdAccessor (&WebSocketPool::m_socketType),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("CloseReleased", "Close released sockets and keep them until TCP reports the close "
+                   "(false: let them go at once without closing, as before the pool)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&WebSocketPool::m_closeReleased),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+WebSocketPool::WebSocketPool ()
+  : m_closeReleased (false),
+    m_created (0),
+    m_released (0),
+    m_reclaimed (0),
+    m_factoryLookups (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+WebSocketPool::~WebSocketPool ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ptr<WebSocketPool>
+WebSocketPool::Get (Ptr<Node> node)
+{
+  Ptr<WebSocketPool> pool = node->GetObject<WebSocketPool> ();
+  if (!pool)
+    {
+      pool = CreateObject<WebSocketPool> ();
+      node->AggregateObject (pool);
+    }
+  return pool;
+}
+
+Ptr<Socket>
+WebSocketPool::Create (void)
+{
+  if (!m_factory)
+    {
+      m_factory = GetObject<SocketFactory> (m_socketType);
+      m_factoryLookups++;
+      NS_ABORT_MSG_IF (!m_factory, "the node has no " << m_socketType.GetName ());
+    }
+  m_created++;
+  return m_factory->CreateSocket ();
+}
+
+void
+WebSocketPool::Release (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  m_released++;
+  if (!m_closeReleased)
+    {
+      m_reclaimed++;
+      return;
+    }
+  socket->SetCloseCallbacks (MakeCallback (&WebSocketPool::Closed, this),
+                             MakeCallback (&WebSocketPool::Closed, this));
+  m_waiting.insert (socket);
+  socket->Close ();
+}
+
+void
+WebSocketPool::Closed (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  if (m_waiting.erase (socket))
+    {
+      m_reclaimed++;
+    }
+}
+
+uint32_t
+WebSocketPool::GetNWaiting (void) const
+{
+  return m_waiting.size ();
+}
+
+uint64_t
+WebSocketPool::GetCreated (void) const
+{
+  return m_created;
+}
+
+uint64_t
+WebSocketPool::GetReleased (void) const
+{
+  return m_released;
+}
+
+uint64_t
+WebSocketPool::GetReclaimed (void) const
+{
+  return m_reclaimed;
+}
+
+uint64_t
+WebSocketPool::GetFactoryLookups (void) const
+{
+  return m_factoryLookups;
+}
+
+void
+WebSocketPool::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_factory = 0;
+  m_waiting.clear ();
+  Object::DoDispose ();
+}
+
+} // namespace ns3
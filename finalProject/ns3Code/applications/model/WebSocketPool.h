@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef WEB_SOCKET_POOL_H
+#define WEB_SOCKET_POOL_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/type-id.h"
+#include <set>
+
+namespace ns3 {
+
+class Node;
+class Socket;
+class SocketFactory;
+
+/**
+ * \ingroup applications
+ *
+ * \brief Per node source of the TcpWebClient sockets
+ *
+ * Aggregated to a node by the first Get.  The socket factory of the node
+ * is looked up once (TypeId by name, then the aggregate search of
+ * Socket::CreateSocket) instead of for every object of every browser.
+ *
+ * A client hands a socket back with Release once its response is complete.
+ * With CloseReleased the pool closes it and keeps it until TCP reports the
+ * close, which for the active closer is after TIME_WAIT, and then lets it
+ * go; otherwise it is let go at once, as the clients always did (they
+ * never closed their sockets).  The socket objects themselves are not
+ * handed out again: a closed TcpSocketBase keeps its sequence numbers,
+ * congestion window and shutdown flags, and ns-3 has no way to reset them.
+ */
+class WebSocketPool : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  WebSocketPool ();
+  virtual ~WebSocketPool ();
+
+  //the pool of node, created and aggregated to it on first use
+  static Ptr<WebSocketPool> Get (Ptr<Node> node);
+
+  //a new socket of the SocketType factory of the node
+  Ptr<Socket> Create (void);
+  //the application is done with socket
+  void Release (Ptr<Socket> socket);
+
+  //released sockets waiting for their close
+  uint32_t GetNWaiting (void) const;
+  uint64_t GetCreated (void) const;
+  uint64_t GetReleased (void) const;
+  //released sockets let go of after their close (or at once without CloseReleased)
+  uint64_t GetReclaimed (void) const;
+  //factory lookups, at most one per pool and socket type
+  uint64_t GetFactoryLookups (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  void Closed (Ptr<Socket> socket);
+
+  TypeId m_socketType; //of the factory
+  bool m_closeReleased;
+  Ptr<SocketFactory> m_factory; //cached, of m_socketType
+  std::set<Ptr<Socket> > m_waiting; //released, not closed yet
+  uint64_t m_created;
+  uint64_t m_released;
+  uint64_t m_reclaimed;
+  uint64_t m_factoryLookups;
+};
+
+} // namespace ns3
+
+#endif /* WEB_SOCKET_POOL_H */
@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "WebSteadyStateDetector.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/trace-source-accessor.h"
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WebSteadyStateDetector");
+
+NS_OBJECT_ENSURE_REGISTERED (WebSteadyStateDetector);
+
+TypeId
+WebSteadyStateDetector::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WebSteadyStateDetector")
+    .SetParent<Object> ()
+    .SetGroupName("Applications")
+    .AddConstructor<WebSteadyStateDetector> ()
+    .AddAttribute ("WarmupTime",
+                   "Observations before this time are discarded",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&WebSteadyStateDetector::m_warmup),
+                   MakeTimeChecker ())
+    .AddAttribute ("BatchInterval",
+                   "Length of one batch",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&WebSteadyStateDetector::m_batchInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("MinBatches",
+                   "Batches needed before the precision is checked",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&WebSteadyStateDetector::m_minBatches),
+                   MakeUintegerChecker<uint32_t> (2))
+    .AddAttribute ("TargetPrecision",
+                   "95% confidence half-width relative to the mean at which steady state is "
+                   "declared (0 never declares it)",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&WebSteadyStateDetector::m_targetPrecision),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("StopSimulation",
+                   "Stop the simulator once steady state is reached",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&WebSteadyStateDetector::m_stopSimulation),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("Batch", "A batch has been closed",
+                     MakeTraceSourceAccessor (&WebSteadyStateDetector::m_batchTrace),
+                     "ns3::WebSteadyStateDetector::BatchTracedCallback")
+    .AddTraceSource ("SteadyState", "The precision target has been reached",
+                     MakeTraceSourceAccessor (&WebSteadyStateDetector::m_steadyStateTrace),
+                     "ns3::TracedCallback::Void")
+  ;
+  return tid;
+}
+
+WebSteadyStateDetector::WebSteadyStateDetector ()
+  : m_batchResponseSum (0),
+    m_batchPages (0),
+    m_batchBytes (0),
+    m_nBatches (0),
+    m_converged (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+WebSteadyStateDetector::~WebSteadyStateDetector ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+WebSteadyStateDetector::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_batchEvent);
+  Object::DoDispose ();
+}
+
+void
+WebSteadyStateDetector::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+  //the first batch starts when the warm-up ends
+  m_batchEvent = Simulator::Schedule (m_warmup + m_batchInterval - Simulator::Now (),
+                                      &WebSteadyStateDetector::EndBatch, this);
+}
+
+void
+WebSteadyStateDetector::NotifyPageComplete (Time start, Time duration)
+{
+  //pages that started in the transient are not representative
+  if (start < m_warmup)
+    {
+      return;
+    }
+  m_batchResponseSum += duration.GetSeconds ();
+  m_batchPages++;
+}
+
+void
+WebSteadyStateDetector::NotifyTx (Ptr<const Packet> packet)
+{
+  if (Simulator::Now () < m_warmup)
+    {
+      return;
+    }
+  m_batchBytes += packet->GetSize ();
+}
+
+void
+WebSteadyStateDetector::EndBatch (void)
+{
+  NS_LOG_FUNCTION (this);
+  double throughput = m_batchBytes * 8.0 / m_batchInterval.GetSeconds ();
+  double responseTime = 0;
+  //a batch without finished pages says nothing about response time
+  if (m_batchPages > 0)
+    {
+      responseTime = m_batchResponseSum / m_batchPages;
+      m_responseTimeBatches.Update (responseTime);
+    }
+  m_throughputBatches.Update (throughput);
+  m_batchTrace (m_nBatches, responseTime, throughput);
+  m_nBatches++;
+  m_batchResponseSum = 0;
+  m_batchPages = 0;
+  m_batchBytes = 0;
+  NS_LOG_INFO ("batch " << m_nBatches << " response time " << GetResponseTimeMean () << " +- "
+               << GetResponseTimeHalfWidth () << " throughput " << GetThroughputMean () << " +- "
+               << GetThroughputHalfWidth ());
+
+  if (m_targetPrecision > 0 && m_responseTimeBatches.Count () >= m_minBatches
+      && m_throughputBatches.Count () >= m_minBatches
+      && GetResponseTimeHalfWidth () <= m_targetPrecision * GetResponseTimeMean ()
+      && GetThroughputHalfWidth () <= m_targetPrecision * GetThroughputMean ())
+    {
+      m_converged = true;
+      m_steadyStateTrace ();
+      if (m_stopSimulation)
+        {
+          Simulator::Stop ();
+        }
+      return;
+    }
+  m_batchEvent = Simulator::Schedule (m_batchInterval, &WebSteadyStateDetector::EndBatch, this);
+}
+
+bool
+WebSteadyStateDetector::IsConverged (void) const
+{
+  return m_converged;
+}
+
+uint32_t
+WebSteadyStateDetector::GetNBatches (void) const
+{
+  return m_nBatches;
+}
+
+double
+WebSteadyStateDetector::GetResponseTimeMean (void) const
+{
+  return m_responseTimeBatches.Count () ? m_responseTimeBatches.Mean () : 0.0;
+}
+
+double
+WebSteadyStateDetector::GetResponseTimeHalfWidth (void) const
+{
+  return HalfWidth (m_responseTimeBatches);
+}
+
+double
+WebSteadyStateDetector::GetThroughputMean (void) const
+{
+  return m_throughputBatches.Count () ? m_throughputBatches.Mean () : 0.0;
+}
+
+double
+WebSteadyStateDetector::GetThroughputHalfWidth (void) const
+{
+  return HalfWidth (m_throughputBatches);
+}
+
+double
+WebSteadyStateDetector::HalfWidth (const Average<double> &avg)
+{
+  if (avg.Count () < 2)
+    {
+      return 0.0;
+    }
+  return StudentT95 (avg.Count () - 1) * std::sqrt (avg.Var () / avg.Count ());
+}
+
+double
+WebSteadyStateDetector::StudentT95 (uint32_t dof)
+{
+  //two sided 95% quantiles for 1..30 degrees of freedom, normal beyond
+  static const double table[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+  };
+  if (dof == 0)
+    {
+      return 0.0;
+    }
+  if (dof <= sizeof (table) / sizeof (table[0]))
+    {
+      return table[dof - 1];
+    }
+  return 1.96;
+}
+
+} // Namespace ns3
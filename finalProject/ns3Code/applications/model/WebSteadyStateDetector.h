@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WEB_STEADY_STATE_DETECTOR_H
+#define WEB_STEADY_STATE_DETECTOR_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/packet.h"
+#include "ns3/traced-callback.h"
+#include "ns3/average.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Online batch means estimator for web response time and bottleneck throughput
+ *
+ * Everything observed before WarmupTime is discarded.  After the warm-up the
+ * simulated time is cut into batches of BatchInterval; the mean response time
+ * and the throughput of every batch are treated as (approximately independent)
+ * samples.  Once MinBatches batches exist and the 95% confidence half-width of
+ * both estimates is below TargetPrecision times their mean, the detector
+ * reports steady state and, if StopSimulation is set, stops the simulator.
+ *
+ * Response times come from the TcpWebClient "PageComplete" trace
+ * (NotifyPageComplete) and bottleneck bytes from a device transmit trace
+ * (NotifyTx).
+ */
+class WebSteadyStateDetector : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  WebSteadyStateDetector ();
+  virtual ~WebSteadyStateDetector ();
+
+  /**
+   * Schedule the first batch boundary, call before Simulator::Run
+   */
+  void Start (void);
+
+  /**
+   * Trace sink for TcpWebClient::PageComplete
+   */
+  void NotifyPageComplete (Time start, Time duration);
+
+  /**
+   * Trace sink for a bottleneck transmit trace (e.g. PhyTxEnd)
+   */
+  void NotifyTx (Ptr<const Packet> packet);
+
+  //true once the precision target has been reached
+  bool IsConverged (void) const;
+  uint32_t GetNBatches (void) const;
+  double GetResponseTimeMean (void) const;
+  double GetResponseTimeHalfWidth (void) const;
+  //bits per second
+  double GetThroughputMean (void) const;
+  double GetThroughputHalfWidth (void) const;
+
+  /**
+   * Two sided 95% quantile of the Student t distribution
+   * \param dof degrees of freedom (samples - 1)
+   */
+  static double StudentT95 (uint32_t dof);
+
+  /**
+   * \param avg independent samples
+   * \return 95% confidence half-width of their mean (0 for less than 2 samples)
+   */
+  static double HalfWidth (const Average<double> &avg);
+
+  /**
+   * TracedCallback signature for a finished batch.
+   *
+   * \param [in] batch index of the batch
+   * \param [in] responseTime mean response time of the batch in seconds
+   * \param [in] throughput bottleneck throughput of the batch in bits/s
+   */
+  typedef void (* BatchTracedCallback)(uint32_t batch, double responseTime, double throughput);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  void EndBatch (void);
+
+  Time m_warmup;
+  Time m_batchInterval;
+  uint32_t m_minBatches;
+  double m_targetPrecision; //relative half-width (0 disables the early stop)
+  bool m_stopSimulation;
+
+  //running sums of the batch in progress
+  double m_batchResponseSum;
+  uint32_t m_batchPages;
+  uint64_t m_batchBytes;
+
+  Average<double> m_responseTimeBatches;
+  Average<double> m_throughputBatches;
+  uint32_t m_nBatches;
+  bool m_converged;
+  EventId m_batchEvent;
+
+  TracedCallback<uint32_t, double, double> m_batchTrace;
+  TracedCallback<> m_steadyStateTrace;
+};
+
+} // namespace ns3
+
+#endif /* WEB_STEADY_STATE_DETECTOR_H */
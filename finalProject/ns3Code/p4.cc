@@ -21,102 +21,261 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/network-module.h"
 #include "ns3/internet-module.h"
+#include "ns3/nix-vector-routing-module.h"
 #include <string>
 #include <fstream>
 #include <vector>
 #include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
 
 
 #define END_TIME 2000.0
+//first stream of the per-browser block (start time generator uses stream 6110)
+#define CLIENT_STREAM_BASE 10000
+//stream of the object sizes of the --objects catalog of server 0, server s uses CATALOG_STREAM+s
+#define CATALOG_STREAM 6111
+//bottleneck rate (Mbps) used for the unconstrained calibration pilots
+#define PILOT_BOTTLENECK_RATE 10000
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("P4Example");
 
-int 
-main (int argc, char *argv[])
+//every command line setting of a run
+typedef struct
 {
-  bool verbose = false;
-  double minTh=5;
-  double maxTh=15;
-  uint32_t numSourceFlows=2;
-  double weightFactor=.002;
-  double maxDropProb=50;
-  uint32_t queueSize=640000;
-  uint64_t bottleneckRate=100;
-  uint32_t recieverWindowSize=32000;
-  double linkDelay=.0005;
-  std::string queueType="";
-  bool isDropTail=true;
-  uint32_t numNodes=1;
-  std::string csv="";
-  //add command line parameters
-  CommandLine cmd;
-  cmd.AddValue ("minTh", "Queue length threshold for triggering probabilistic drops", minTh);
-  cmd.AddValue ("maxTh", "Queue length threshold for triggering forced drops.", maxTh);
-  cmd.AddValue ("weightFactor", "Weighting factor for the average queue length computation.",weightFactor);
-  cmd.AddValue ("maxDropProb", "The maximum probability of performing an early drop as percent (50=50%).",maxDropProb);
-  cmd.AddValue ("queueSize", "Queue Size at Bottleneck Link", queueSize);
-  cmd.AddValue ("verbose", "Enable Informational Logging", verbose);
-  cmd.AddValue("nFlows","Number of Flows on one node from source -> Receiver",numSourceFlows);
-  cmd.AddValue("isDropTail","Boolean to toggle between Droptail and Red (True=DropTail)",isDropTail);
-  cmd.AddValue("bottleneckRate","Rate of bottleneckLink in Mbps",bottleneckRate);
-  cmd.AddValue ("receiverWindowSize", "TCP Advertised Reciever Window Size", recieverWindowSize);
-  cmd.AddValue("linkDelays","Delays of all links in system in seconds",linkDelay);
-  cmd.AddValue("nNodes","Number of Nodes in the Simulation",numNodes);
-  cmd.AddValue("csv","Csv filename for run",csv);
-  cmd.Parse (argc,argv);
+  bool verbose;
+  double minTh;
+  double maxTh;
+  uint32_t numSourceFlows;
+  double weightFactor;
+  double maxDropProb;
+  uint32_t queueSize;
+  uint64_t bottleneckRate; //Mbps
+  uint32_t recieverWindowSize;
+  double linkDelay;
+  bool isDropTail;
+  std::string aqm; //bottleneck queue description for WebQueueHelper ("" = isDropTail on every link)
+  std::string topology; //description file for WebTopologyHelper ("" = the two dumbbells)
+  std::string routing; //global, nix or static
+  std::string profile; //csv the wall clock, event and memory profile of the run is appended to ("" = none)
+  std::string eventLog; //binary log of the web application events (WebEventLog, "" = none)
+  uint32_t objects; //objects of each server's catalog, what secondary requests ask for (0 = no object ids)
+  double zipfAlpha; //popularity exponent of the catalogs
+  uint64_t proxyCache; //bytes of the caching proxy in front of the bottleneck (0 = no proxy)
+  std::string proxyPolicy; //LRU or LFU
+  std::string serverScheduler; //none, fifo, srpt or fair
+  uint32_t schedulerQuantum; //bytes the server scheduler hands to TCP at once
+  double serverRate; //Mbps the server scheduler hands quanta at (0=no limit)
+  uint32_t smallObject; //responses up to this many bytes are small in the object times
+  bool compression; //servers compress the responses, browsers expect the compressed sizes
+  double compressionCpu; //nanoseconds of server worker time per byte compressed
+  uint32_t numNodes;
+  std::string csv;
+  double simTime;
+  double warmup;
+  double targetPrecision;
+  double batchInterval;
+  uint32_t minBatches;
+  double calibrate; //target bottleneck utilization (0=normal run)
+  double pilotTime;
+  double calibrationTolerance;
+  std::string cdf; //file for the response time CDF and percentiles ("" = none)
+  std::string percentiles; //comma separated percentiles to report
+  bool rawSamples; //also write every page to csv/stdout
+  std::string out; //columnar binary result file ("" = none)
+  uint32_t forkReplications; //replications forked after the warm-up (0=normal run)
+  uint32_t replications; //independent replications (0=normal run)
+  uint32_t forkWorkers; //concurrent replications (0=one per core)
+  std::string queueTrace; //bottleneck queue record file ("" = totals only)
+  double queueSampleInterval; //seconds between queue records (0=every event)
+} P4Config;
 
+//what a browser's PageComplete sink needs and counts
+typedef struct
+{
+  WebResponseHistogram *histogram; //of the browser's client node
+  double warmup;
+  uint32_t pages;
+  double responseTimeSum;
+} P4PageSink;
 
-  //get in terms of Mbps
-  bottleneckRate*=1000000;
+//fetch times of the small and of the large objects of all browsers
+typedef struct
+{
+  WebResponseHistogram small;
+  WebResponseHistogram large;
+  uint32_t smallBytes; //largest small response
+  double warmup;
+} P4ObjectSink;
 
-  //all values are inital defaults right now
-  if(isDropTail){
-	  queueType="ns3::DropTailQueue";
-	  Config::SetDefault("ns3::DropTailQueue::Mode",EnumValue(ns3::DropTailQueue::QUEUE_MODE_BYTES));
-	  Config::SetDefault("ns3::DropTailQueue::MaxBytes",UintegerValue(queueSize));
+//what a run builds and what is read back after it
+typedef struct
+{
+  NodeContainer clientNodes; //left leaves of the client dumbbell
+  NodeContainer serverNodes; //right leaves of the server dumbbell
+  NetDeviceContainer bottleneckDevices; //Get(1) transmits server->client
+  ApplicationContainer sinkApps;
+  ApplicationContainer sourceApps;
+  Ptr<WebSteadyStateDetector> detector;
+  Ptr<WebQueueRecorder> queueRecorder; //server->client bottleneck queue
+  std::vector<WebResponseHistogram> nodeHistograms; //one per client node
+  std::vector<P4PageSink> pageSinks; //one per source app
+  P4ObjectSink objectSink;
+  std::vector<Ptr<WebObjectCatalog> > catalogs; //of each server, shared with its browsers (--objects)
+  Ptr<TcpWebProxy> proxy; //on the client side of the bottleneck (--proxyCache)
+  Ptr<WebCompressionModel> compression; //shared by the servers, the browsers and the proxy (--compression)
+  double buildSeconds; //wall clock of BuildScenario
+  double topologySeconds; //of which nodes, links and addresses
+  double installSeconds; //applications, detector and recorders
+  double routingSeconds; //computing the routes
+  double runSeconds; //Simulator::Run
+  double outputSeconds; //WriteResults
+  long routingRssKb; //peak resident memory added by computing the routes
+  uint32_t routes; //static routes added (--routing=static)
+} P4Scenario;
 
-  }
-  else{
-	  queueType="ns3::RedQueue";
-	  Config::SetDefault("ns3::RedQueue::Mode", EnumValue(ns3::RedQueue::QUEUE_MODE_BYTES));
-	  Config::SetDefault("ns3::RedQueue::MinTh", DoubleValue(minTh));
-	  Config::SetDefault("ns3::RedQueue::MaxTh",DoubleValue(maxTh));
-	  Config::SetDefault("ns3::RedQueue::QueueLimit",UintegerValue(queueSize));
-	  Config::SetDefault("ns3::RedQueue::QW",DoubleValue(weightFactor));
-	  Config::SetDefault("ns3::RedQueue::LInterm",DoubleValue(maxDropProb));
-  }
+//adds an object to the small or the large histogram, objects started in the warm-up are left out
+static void
+RecordObject (P4ObjectSink *sink, uint32_t size, Time duration)
+{
+  if((Simulator::Now()-duration).GetSeconds()<sink->warmup)
+	  return;
+  if(size<=sink->smallBytes)
+	  sink->small.Record(duration.GetSeconds());
+  else
+	  sink->large.Record(duration.GetSeconds());
+}
+
+//server scheduler of a --serverScheduler name
+static TcpWebServer::Scheduler
+ParseScheduler (const std::string &name)
+{
+  if(name=="fifo")
+	  return TcpWebServer::FIFO;
+  if(name=="srpt")
+	  return TcpWebServer::SRPT;
+  if(name=="fair")
+	  return TcpWebServer::FAIR;
+  NS_ABORT_MSG_IF(name!="none","--serverScheduler must be none, fifo, srpt or fair");
+  return TcpWebServer::NONE;
+}
+
+//adds a page to its client node's histogram, using the same warm-up cut as the raw samples
+static void
+RecordPage (P4PageSink *sink, Time start, Time duration)
+{
+  if(start.GetSeconds()<sink->warmup)
+	  return;
+  sink->histogram->Record(duration.GetSeconds());
+  sink->pages++;
+  sink->responseTimeSum+=duration.GetSeconds();
+}
+
+template <typename T>
+static std::string
+ToString (const T &v)
+{
+  std::ostringstream os;
+  os << v;
+  return os.str();
+}
+
+//wall clock seconds
+static double
+WallClock (void)
+{
+  struct timeval tv;
+  gettimeofday(&tv,0);
+  return tv.tv_sec+tv.tv_usec/1e6;
+}
+
+//peak resident memory of this process
+static long
+PeakRssKb (void)
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF,&usage);
+  return usage.ru_maxrss;
+}
+
+//stack routing for --routing=nix: the list asks the higher priority first, so nix vectors (built on demand)
+//route first and static only gets what nix does not route
+static Ipv4ListRoutingHelper
+NixRouting (void)
+{
+  Ipv4StaticRoutingHelper staticRouting;
+  Ipv4NixVectorHelper nixRouting;
+  Ipv4ListRoutingHelper list;
+  list.Add(staticRouting,0);
+  list.Add(nixRouting,10);
+  return list;
+}
+
+//sets the queue/tcp defaults used by every device and socket created afterwards,
+//returns the queue type of the links built by the point to point helpers
+static std::string
+ConfigureDefaults (const P4Config &cfg)
+{
+  //all values are inital defaults right now; --aqm attributes are applied on top of them
+  Config::SetDefault("ns3::DropTailQueue::Mode",EnumValue(ns3::DropTailQueue::QUEUE_MODE_BYTES));
+  Config::SetDefault("ns3::DropTailQueue::MaxBytes",UintegerValue(cfg.queueSize));
+  Config::SetDefault("ns3::RedQueue::Mode", EnumValue(ns3::RedQueue::QUEUE_MODE_BYTES));
+  Config::SetDefault("ns3::RedQueue::MinTh", DoubleValue(cfg.minTh));
+  Config::SetDefault("ns3::RedQueue::MaxTh",DoubleValue(cfg.maxTh));
+  Config::SetDefault("ns3::RedQueue::QueueLimit",UintegerValue(cfg.queueSize));
+  Config::SetDefault("ns3::RedQueue::QW",DoubleValue(cfg.weightFactor));
+  Config::SetDefault("ns3::RedQueue::LInterm",DoubleValue(cfg.maxDropProb));
+  Config::SetDefaultFailSafe("ns3::CoDelQueue::Mode",StringValue("QUEUE_MODE_BYTES"));
+  Config::SetDefaultFailSafe("ns3::CoDelQueue::MaxBytes",UintegerValue(cfg.queueSize));
+  //with --aqm only the bottleneck gets the discipline, every other link is a DropTail
+  std::string queueType=(cfg.isDropTail || cfg.aqm!="") ? "ns3::DropTailQueue" : "ns3::RedQueue";
   Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(ns3::TcpNewReno::GetTypeId()));
   //Make sure packets lost bc of queues along the way not at hosts
   Config::SetDefault("ns3::TcpSocket::SndBufSize",UintegerValue(0xffffffff));
-  Config::SetDefault("ns3::UdpSocket::RcvBufSize",UintegerValue(recieverWindowSize));
+  Config::SetDefault("ns3::UdpSocket::RcvBufSize",UintegerValue(cfg.recieverWindowSize));
   Config::SetDefault ("ns3::TcpSocketBase::WindowScaling", BooleanValue (false));
+  //the histograms replace the per-page vectors when raw samples are not wanted
+  Config::SetDefault("ns3::TcpWebClient::StoreResponseTimes",BooleanValue(cfg.rawSamples));
+  return queueType;
+}
 
-  if (verbose)
-  {
-	  LogComponentEnable ("TcpWebClientApplication", LOG_LEVEL_FUNCTION);
-	  LogComponentEnable ("TcpWebServerApplication", LOG_LEVEL_FUNCTION);
-  }
+//builds the two dumbbells joined by the bottleneck, client node i browses server node i
+static void
+BuildDumbbells (const P4Config &cfg, const std::string &queueType, P4Scenario &sc, std::vector<Ipv4Address> &serverOf)
+{
+  //get in terms of Mbps
+  uint64_t bottleneckRate=cfg.bottleneckRate*1000000;
 
   //type of links in the topology
   PointToPointHelper tenMbpsLink;
   tenMbpsLink.SetDeviceAttribute ("DataRate", StringValue("10Mbps"));
-  tenMbpsLink.SetChannelAttribute ("Delay", TimeValue(Seconds(linkDelay)));
+  tenMbpsLink.SetChannelAttribute ("Delay", TimeValue(Seconds(cfg.linkDelay)));
   tenMbpsLink.SetQueue(queueType);
   PointToPointHelper hundredMbpsLink;
   hundredMbpsLink.SetDeviceAttribute("DataRate",StringValue("100Mbps"));
-  hundredMbpsLink.SetChannelAttribute("Delay",TimeValue(Seconds(linkDelay)));
+  hundredMbpsLink.SetChannelAttribute("Delay",TimeValue(Seconds(cfg.linkDelay)));
   hundredMbpsLink.SetQueue(queueType);
   PointToPointHelper bottleNeckLink;
   bottleNeckLink.SetDeviceAttribute("DataRate",DataRateValue(DataRate(bottleneckRate)));
-  bottleNeckLink.SetChannelAttribute("Delay",TimeValue(Seconds(linkDelay)));
+  bottleNeckLink.SetChannelAttribute("Delay",TimeValue(Seconds(cfg.linkDelay)));
   bottleNeckLink.SetQueue(queueType);
 
 
   //note lwo leftmost arguments can just make one coherent pipe (with a forwarding spot)
   //PointToPointDumbbellHelper d(numSourceFlows,tenMbpsLink,1,hundredMbpsLink,hundredMbpsLink);
-  PointToPointDumbbellHelper d(numNodes,tenMbpsLink,1,hundredMbpsLink,hundredMbpsLink);
+  PointToPointDumbbellHelper d(cfg.numNodes,tenMbpsLink,1,hundredMbpsLink,hundredMbpsLink);
   InternetStackHelper stack;
+  if(cfg.routing=="nix")
+	  stack.SetRoutingHelper(NixRouting());
   d.InstallStack(stack);
   // Assign IP Addresses
   d.AssignIpv4Addresses (Ipv4AddressHelper ("10.1.0.0", "255.255.255.0"),Ipv4AddressHelper ("10.3.0.0", "255.255.255.0"),
@@ -124,7 +283,7 @@ main (int argc, char *argv[])
 
   //note 2nd arg and last arg form pipe to other side
   //PointToPointDumbbellHelper serverSide(1,hundredMbpsLink,numSourceFlows,tenMbpsLink,hundredMbpsLink);
-  PointToPointDumbbellHelper serverSide(1,hundredMbpsLink,numNodes,tenMbpsLink,hundredMbpsLink);
+  PointToPointDumbbellHelper serverSide(1,hundredMbpsLink,cfg.numNodes,tenMbpsLink,hundredMbpsLink);
 
   serverSide.InstallStack(stack);
   serverSide.AssignIpv4Addresses (Ipv4AddressHelper ("10.7.0.0", "255.255.255.0"),Ipv4AddressHelper ("10.9.0.0", "255.255.255.0"),
@@ -133,73 +292,1002 @@ main (int argc, char *argv[])
   NodeContainer nodes;
   nodes.Add(d.GetRight(0));
   nodes.Add(serverSide.GetLeft(0));
-  NetDeviceContainer devices;
-  devices = bottleNeckLink.Install(nodes);
+  sc.bottleneckDevices = bottleNeckLink.Install(nodes);
   Ipv4AddressHelper address;
   address.SetBase ("10.6.0.0", "255.255.255.0");
-  Ipv4InterfaceContainer interfaces = address.Assign(devices);
+  Ipv4InterfaceContainer interfaces = address.Assign(sc.bottleneckDevices);
+  for(uint32_t i=0;i<d.LeftCount();i++){
+	  sc.clientNodes.Add(d.GetLeft(i));
+	  serverOf.push_back(serverSide.GetRightIpv4Address(i));
+  }
+  for(uint32_t i=0;i<serverSide.RightCount();i++){
+	  sc.serverNodes.Add(serverSide.GetRight(i));
+  }
+}
+
+//builds the --topology description, client node i browses server node i modulo the servers
+static void
+BuildDescribedTopology (const P4Config &cfg, const std::string &queueType, P4Scenario &sc, std::vector<Ipv4Address> &serverOf)
+{
+  WebTopologyHelper topology;
+  topology.SetQueue(queueType);
+  if(cfg.routing=="nix")
+	  topology.SetRoutingHelper(NixRouting());
+  topology.SetVariable("bottleneckRate",ToString(cfg.bottleneckRate)+"Mbps");
+  topology.SetVariable("linkDelays",ToString(cfg.linkDelay)+"s");
+  topology.Load(cfg.topology);
+  topology.Build();
+  sc.clientNodes=topology.GetClientNodes();
+  sc.serverNodes=topology.GetServerNodes();
+  NS_ABORT_MSG_IF(sc.clientNodes.GetN()==0 || sc.serverNodes.GetN()==0,cfg.topology << " needs clients and servers");
+  for(uint32_t i=0;i<sc.clientNodes.GetN();i++){
+	  serverOf.push_back(topology.GetServerAddress(i%sc.serverNodes.GetN()));
+  }
+  //the first link named bottleneck, its b side transmitting towards the clients
+  NetDeviceContainer bottleneck=topology.GetLinkDevices("bottleneck");
+  sc.bottleneckDevices=NetDeviceContainer(bottleneck.Get(0),bottleneck.Get(1));
+}
 
+//builds topology, applications and the steady state detector of one run
+static void
+BuildScenario (const P4Config &cfg, P4Scenario &sc)
+{
+  double buildStart=WallClock();
+  std::string queueType=ConfigureDefaults(cfg);
+  std::vector<Ipv4Address> serverOf; //server address of every client node
+  if(cfg.topology!=""){
+	  BuildDescribedTopology(cfg,queueType,sc,serverOf);
+  }
+  else{
+	  BuildDumbbells(cfg,queueType,sc,serverOf);
+  }
+  if(cfg.aqm!=""){
+	  WebQueueHelper aqm;
+	  aqm.SetQueue(cfg.aqm);
+	  aqm.Install(sc.bottleneckDevices);
+  }
+  sc.topologySeconds=WallClock()-buildStart;
+
+  //the objects of every server, ids interleaved so that id modulo the number of servers is the server
+  if(cfg.objects>0){
+	  NS_ABORT_MSG_IF(CATALOG_STREAM+sc.serverNodes.GetN()>CLIENT_STREAM_BASE,"too many servers for the catalog streams");
+	  for(uint32_t i=0;i<sc.serverNodes.GetN();i++){
+		  Ptr<WebObjectCatalog> catalog=CreateObject<WebObjectCatalog>();
+		  catalog->SetAttribute("IdOffset",UintegerValue(i));
+		  catalog->SetAttribute("IdStride",UintegerValue(sc.serverNodes.GetN()));
+		  catalog->Build(cfg.objects,cfg.zipfAlpha,CATALOG_STREAM+i);
+		  sc.catalogs.push_back(catalog);
+	  }
+  }
+  //one compression model, so every side computes the same compressed sizes
+  if(cfg.compression){
+	  sc.compression=CreateObject<WebCompressionModel>();
+	  sc.compression->SetAttribute("CpuPerByte",TimeValue(NanoSeconds(cfg.compressionCpu)));
+  }
   //create sink to get packets
   uint16_t tcpStartSinkPort = 80;
-  ApplicationContainer sinkApps;
   //std::cout << "SETTING SERVERS " << std::endl;
-  for(uint32_t i=0;i<serverSide.RightCount();i++){
+  for(uint32_t i=0;i<sc.serverNodes.GetN();i++){
 	  TcpWebServerHelper server("ns3::TcpSocketFactory",InetSocketAddress(Ipv4Address::GetAny(),tcpStartSinkPort));
-	  ApplicationContainer sinkApp = server.Install(serverSide.GetRight(i));
+	  if(cfg.objects>0)
+		  server.SetAttribute("Catalog",PointerValue(sc.catalogs[i]));
+	  server.SetAttribute("Scheduler",EnumValue(ParseScheduler(cfg.serverScheduler)));
+	  server.SetAttribute("Quantum",UintegerValue(cfg.schedulerQuantum));
+	  server.SetAttribute("ServiceRate",DataRateValue(DataRate((uint64_t)(cfg.serverRate*1000000))));
+	  if(sc.compression)
+		  server.SetAttribute("Compression",PointerValue(sc.compression));
+	  ApplicationContainer sinkApp = server.Install(sc.serverNodes.Get(i));
 	  sinkApp.Start(Seconds(0.0));
-	  sinkApp.Stop(Seconds (END_TIME));
-	  sinkApps.Add(sinkApp);
+	  sinkApp.Stop(Seconds (cfg.simTime));
+	  sc.sinkApps.Add(sinkApp);
   }
   //std::cout << "DONE SETTING SERVERS " << std::endl;
-  ApplicationContainer sourceApps;
+  //the proxy at the client side end of the bottleneck takes the browsers' connections, the servers are its origins
+  std::vector<Ipv4Address> browseTo=serverOf;
+  if(cfg.proxyCache>0){
+	  Ptr<NetDevice> edgeDevice=sc.bottleneckDevices.Get(0);
+	  Ptr<Ipv4> edgeIpv4=edgeDevice->GetNode()->GetObject<Ipv4>();
+	  Ipv4Address proxyAddress=edgeIpv4->GetAddress(edgeIpv4->GetInterfaceForDevice(edgeDevice),0).GetLocal();
+	  sc.proxy=CreateObject<TcpWebProxy>();
+	  sc.proxy->SetAttribute("Local",AddressValue(InetSocketAddress(Ipv4Address::GetAny(),tcpStartSinkPort)));
+	  sc.proxy->SetAttribute("OriginPort",UintegerValue(tcpStartSinkPort));
+	  sc.proxy->SetAttribute("CacheBytes",UintegerValue(cfg.proxyCache));
+	  sc.proxy->SetAttribute("Policy",EnumValue(cfg.proxyPolicy=="LFU" ? WebObjectCache::LFU : WebObjectCache::LRU));
+	  if(sc.compression)
+		  sc.proxy->SetAttribute("Compression",PointerValue(sc.compression));
+	  //in server order, as the catalogs' ids
+	  for(uint32_t i=0;i<sc.serverNodes.GetN();i++){
+		  Ptr<Ipv4> serverIpv4=sc.serverNodes.Get(i)->GetObject<Ipv4>();
+		  sc.proxy->AddOrigin(serverIpv4->GetAddress(1,0).GetLocal());
+	  }
+	  for(uint32_t i=0;i<browseTo.size();i++){
+		  browseTo[i]=proxyAddress;
+	  }
+	  edgeDevice->GetNode()->AddApplication(sc.proxy);
+	  sc.proxy->SetStartTime(Seconds(0.0));
+	  sc.proxy->SetStopTime(Seconds(cfg.simTime));
+  }
   //install multiple apps on the one machine (each w/ different source ports)
   RngSeedManager::SetSeed(11223344);
   Ptr<UniformRandomVariable> randGenerator = CreateObject<UniformRandomVariable>();
   randGenerator->SetAttribute("Stream",IntegerValue(6110));
   randGenerator->SetAttribute("Min",DoubleValue(0.0));
   randGenerator->SetAttribute("Max",DoubleValue(0.1));
-  std::vector<double> startTimes;
-  for(uint32_t i=0;i<d.LeftCount();i++)
+  for(uint32_t i=0;i<sc.clientNodes.GetN();i++)
   {
-	  for(uint16_t j=0;j<numSourceFlows;j++){
-		  TcpWebClientHelper source (Address(serverSide.GetRightIpv4Address(i)),tcpStartSinkPort);
-		  ApplicationContainer sourceApp = source.Install(d.GetLeft(i));
+	  TcpWebClientHelper source (Address(browseTo[i]),tcpStartSinkPort);
+	  //the builders pair client node i with server node i modulo the servers
+	  if(cfg.objects>0)
+		  source.SetAttribute("Catalog",PointerValue(sc.catalogs[i%sc.serverNodes.GetN()]));
+	  if(sc.compression)
+		  source.SetAttribute("Compression",PointerValue(sc.compression));
+	  for(uint16_t j=0;j<cfg.numSourceFlows;j++){
+		  ApplicationContainer sourceApp = source.Install(sc.clientNodes.Get(i));
 		  double startTime=randGenerator->GetValue();
-		  startTimes.push_back(startTime);
 		  sourceApp.Start(Seconds(startTime));
-		  sourceApp.Stop(Seconds(END_TIME));
-		  sourceApps.Add(sourceApp);
+		  sourceApp.Stop(Seconds(cfg.simTime));
+		  sc.sourceApps.Add(sourceApp);
 	  }
+	  //pin the browsers' streams by (node, browser index) so any split of the population reproduces them
+	  source.AssignStreams(NodeContainer(sc.clientNodes.Get(i)),CLIENT_STREAM_BASE,cfg.numSourceFlows);
   }
-  //populate routing tables
-  Ipv4GlobalRoutingHelper::PopulateRoutingTables();
-  Simulator::Stop(Seconds(END_TIME));
-  Simulator::Run();
-  if(csv==""){
-	  for(uint32_t i=0;i<sourceApps.GetN();i++){
+  //batch means on response time and bottleneck (server->client) throughput after the warm-up
+  sc.detector = CreateObject<WebSteadyStateDetector>();
+  sc.detector->SetAttribute("WarmupTime",TimeValue(Seconds(cfg.warmup)));
+  sc.detector->SetAttribute("BatchInterval",TimeValue(Seconds(cfg.batchInterval)));
+  sc.detector->SetAttribute("MinBatches",UintegerValue(cfg.minBatches));
+  sc.detector->SetAttribute("TargetPrecision",DoubleValue(cfg.targetPrecision));
+  for(uint32_t i=0;i<sc.sourceApps.GetN();i++){
+	  sc.sourceApps.Get(i)->TraceConnectWithoutContext("PageComplete",
+			  MakeCallback(&WebSteadyStateDetector::NotifyPageComplete,sc.detector));
+  }
+  //per client node response time histograms (sized before taking pointers into them)
+  sc.nodeHistograms.resize(sc.clientNodes.GetN());
+  sc.pageSinks.resize(sc.sourceApps.GetN());
+  for(uint32_t i=0;i<sc.sourceApps.GetN();i++){
+	  sc.pageSinks[i].histogram=&sc.nodeHistograms[i/cfg.numSourceFlows];
+	  sc.pageSinks[i].warmup=cfg.warmup;
+	  sc.pageSinks[i].pages=0;
+	  sc.pageSinks[i].responseTimeSum=0;
+	  sc.sourceApps.Get(i)->TraceConnectWithoutContext("PageComplete",
+			  MakeBoundCallback(&RecordPage,&sc.pageSinks[i]));
+  }
+  //small against large object fetch times, what the server scheduler trades
+  sc.objectSink.smallBytes=cfg.smallObject;
+  sc.objectSink.warmup=cfg.warmup;
+  for(uint32_t i=0;i<sc.sourceApps.GetN();i++){
+	  sc.sourceApps.Get(i)->TraceConnectWithoutContext("ObjectComplete",
+			  MakeBoundCallback(&RecordObject,&sc.objectSink));
+  }
+  sc.bottleneckDevices.Get(1)->TraceConnectWithoutContext("PhyTxEnd",MakeCallback(&WebSteadyStateDetector::NotifyTx,sc.detector));
+  sc.detector->Start();
+  //the queue that fills is the one feeding the server->client direction of the bottleneck
+  sc.queueRecorder = CreateObject<WebQueueRecorder>();
+  sc.queueRecorder->SetAttribute("AverageWeight",DoubleValue(cfg.weightFactor));
+  sc.queueRecorder->SetAttribute("SampleInterval",TimeValue(Seconds(cfg.queueSampleInterval)));
+  sc.queueRecorder->Attach(DynamicCast<PointToPointNetDevice>(sc.bottleneckDevices.Get(1))->GetQueue());
+  //global tables on every node, nix vectors per destination while running, or the tree's static routes
+  double routingStart=WallClock();
+  sc.installSeconds=routingStart-buildStart-sc.topologySeconds;
+  long rssBefore=PeakRssKb();
+  sc.routes=0;
+  if(cfg.routing=="global"){
+	  Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+  }
+  else if(cfg.routing=="static"){
+	  sc.routes=WebTreeRoutingHelper::Populate(NodeContainer::GetGlobal());
+  }
+  sc.routingSeconds=WallClock()-routingStart;
+  sc.routingRssKb=PeakRssKb()-rssBefore;
+  sc.buildSeconds=WallClock()-buildStart;
+}
+
+//writes the CDF points and the requested percentiles of one histogram
+static void
+WriteHistogram (std::ostream &os, const std::string &scope, const WebResponseHistogram &h, const std::vector<double> &percentiles)
+{
+  std::vector<WebResponseHistogram::CdfPoint> cdf=h.GetCdf();
+  for(uint32_t i=0;i<cdf.size();i++){
+	  os << "cdf," << scope << "," << cdf[i].value << "," << cdf[i].cumulative << std::endl;
+  }
+  for(uint32_t i=0;i<percentiles.size();i++){
+	  os << "percentile," << scope << "," << percentiles[i] << "," << h.GetQuantile(percentiles[i]/100) << std::endl;
+  }
+  os << "count," << scope << "," << h.GetCount() << "," << h.GetMean() << std::endl;
+}
+
+//writes the run configuration, summaries and (if wanted) every page to a columnar binary file
+static void
+WriteBinaryResults (const P4Config &cfg, const P4Scenario &sc, const WebResponseHistogram &all,
+		const std::vector<double> &percentiles)
+{
+  WebResultWriter w;
+  if(!w.Open(cfg.out)){
+	  NS_FATAL_ERROR("cannot open " << cfg.out);
+  }
+  w.SetConfig("program","p4");
+  w.SetConfig("nNodes",ToString(cfg.numNodes));
+  w.SetConfig("nFlows",ToString(cfg.numSourceFlows));
+  w.SetConfig("bottleneckRate",ToString(cfg.bottleneckRate));
+  w.SetConfig("isDropTail",ToString(cfg.isDropTail));
+  w.SetConfig("aqm",cfg.aqm);
+  w.SetConfig("topology",cfg.topology);
+  w.SetConfig("routing",cfg.routing);
+  w.SetConfig("objects",ToString(cfg.objects));
+  w.SetConfig("zipfAlpha",ToString(cfg.zipfAlpha));
+  w.SetConfig("proxyCache",ToString(cfg.proxyCache));
+  w.SetConfig("proxyPolicy",cfg.proxyPolicy);
+  w.SetConfig("serverScheduler",cfg.serverScheduler);
+  w.SetConfig("schedulerQuantum",ToString(cfg.schedulerQuantum));
+  w.SetConfig("serverRate",ToString(cfg.serverRate));
+  w.SetConfig("compression",cfg.compression ? "true" : "false");
+  w.SetConfig("compressionCpu",ToString(cfg.compressionCpu));
+  w.SetConfig("queueSize",ToString(cfg.queueSize));
+  w.SetConfig("minTh",ToString(cfg.minTh));
+  w.SetConfig("maxTh",ToString(cfg.maxTh));
+  w.SetConfig("weightFactor",ToString(cfg.weightFactor));
+  w.SetConfig("maxDropProb",ToString(cfg.maxDropProb));
+  w.SetConfig("receiverWindowSize",ToString(cfg.recieverWindowSize));
+  w.SetConfig("linkDelays",ToString(cfg.linkDelay));
+  w.SetConfig("simTime",ToString(cfg.simTime));
+  w.SetConfig("warmup",ToString(cfg.warmup));
+  w.SetConfig("targetPrecision",ToString(cfg.targetPrecision));
+  w.SetConfig("seed",ToString(RngSeedManager::GetSeed()));
+  w.SetConfig("run",ToString(RngSeedManager::GetRun()));
+
+  uint32_t summary=w.AddTable("summary");
+  w.AddColumn(summary,"simulatedTime",WebResultFile::TIME);
+  w.AddColumn(summary,"steadyState",WebResultFile::UINT64);
+  w.AddColumn(summary,"batches",WebResultFile::UINT64);
+  w.AddColumn(summary,"meanResponseTime",WebResultFile::DOUBLE);
+  w.AddColumn(summary,"meanResponseTimeHalfWidth",WebResultFile::DOUBLE);
+  w.AddColumn(summary,"throughputBps",WebResultFile::DOUBLE);
+  w.AddColumn(summary,"throughputBpsHalfWidth",WebResultFile::DOUBLE);
+  w.AddColumn(summary,"pages",WebResultFile::UINT64);
+  w.AddTime(summary,0,Simulator::Now().GetSeconds());
+  w.AddUint64(summary,1,sc.detector->IsConverged());
+  w.AddUint64(summary,2,sc.detector->GetNBatches());
+  w.AddDouble(summary,3,sc.detector->GetResponseTimeMean());
+  w.AddDouble(summary,4,sc.detector->GetResponseTimeHalfWidth());
+  w.AddDouble(summary,5,sc.detector->GetThroughputMean());
+  w.AddDouble(summary,6,sc.detector->GetThroughputHalfWidth());
+  w.AddUint64(summary,7,all.GetCount());
+  w.EndRow(summary);
+
+  uint32_t queue=w.AddTable("bottleneckQueue");
+  w.AddColumn(queue,"enqueues",WebResultFile::UINT64);
+  w.AddColumn(queue,"earlyDrops",WebResultFile::UINT64);
+  w.AddColumn(queue,"forcedDrops",WebResultFile::UINT64);
+  w.AddColumn(queue,"maxBytes",WebResultFile::UINT64);
+  w.AddColumn(queue,"timeAverageBytes",WebResultFile::DOUBLE);
+  w.AddUint64(queue,0,sc.queueRecorder->GetEnqueues());
+  w.AddUint64(queue,1,sc.queueRecorder->GetEarlyDrops());
+  w.AddUint64(queue,2,sc.queueRecorder->GetForcedDrops());
+  w.AddUint64(queue,3,sc.queueRecorder->GetMaxBytes());
+  w.AddDouble(queue,4,sc.queueRecorder->GetTimeAverageBytes());
+  w.EndRow(queue);
+
+  //TCPWEB_COUNTERS builds only: one row per application type, columns as TcpWebCounters::Counter
+  if(TcpWebCounters::IsEnabled()){
+	  uint32_t counters=w.AddTable("appCounters");
+	  w.AddColumn(counters,"app",WebResultFile::UINT64);
+	  for(uint32_t c=0;c<TcpWebCounters::N_COUNTERS;c++){
+		  w.AddColumn(counters,TcpWebCounters::GetCounterName((TcpWebCounters::Counter)c),WebResultFile::UINT64);
+	  }
+	  for(uint32_t a=0;a<TcpWebCounters::N_APPS;a++){
+		  w.AddUint64(counters,0,a);
+		  for(uint32_t c=0;c<TcpWebCounters::N_COUNTERS;c++){
+			  w.AddUint64(counters,c+1,TcpWebCounters::Get((TcpWebCounters::App)a,(TcpWebCounters::Counter)c));
+		  }
+		  w.EndRow(counters);
+	  }
+  }
+
+  //--objects: one row per object a server was asked for, for hot object analysis
+  if(cfg.objects>0){
+	  uint32_t objects=w.AddTable("objectRequests");
+	  w.AddColumn(objects,"server",WebResultFile::UINT64);
+	  w.AddColumn(objects,"rank",WebResultFile::UINT64);
+	  w.AddColumn(objects,"id",WebResultFile::UINT64);
+	  w.AddColumn(objects,"size",WebResultFile::UINT64);
+	  w.AddColumn(objects,"requests",WebResultFile::UINT64);
+	  for(uint32_t i=0;i<sc.sinkApps.GetN();i++){
+		  Ptr<TcpWebServer> server=DynamicCast<TcpWebServer>(sc.sinkApps.Get(i));
+		  const std::vector<uint32_t> &requests=server->GetObjectRequests();
+		  for(uint32_t r=0;r<requests.size();r++){
+			  if(requests[r]==0)
+				  continue;
+			  uint32_t id=server->GetCatalog()->GetId(r);
+			  w.AddUint64(objects,0,i);
+			  w.AddUint64(objects,1,r);
+			  w.AddUint64(objects,2,id);
+			  w.AddUint64(objects,3,server->GetCatalog()->GetSize(id));
+			  w.AddUint64(objects,4,requests[r]);
+			  w.EndRow(objects);
+		  }
+	  }
+  }
+
+  //scope -1 is the global histogram, otherwise the client node index
+  uint32_t percentileTable=w.AddTable("percentiles");
+  w.AddColumn(percentileTable,"scope",WebResultFile::INT64);
+  w.AddColumn(percentileTable,"percentile",WebResultFile::DOUBLE);
+  w.AddColumn(percentileTable,"responseTime",WebResultFile::DOUBLE);
+  uint32_t cdfTable=w.AddTable("cdf");
+  w.AddColumn(cdfTable,"scope",WebResultFile::INT64);
+  w.AddColumn(cdfTable,"responseTime",WebResultFile::DOUBLE);
+  w.AddColumn(cdfTable,"cumulative",WebResultFile::DOUBLE);
+  for(int32_t scope=-1;scope<(int32_t)sc.nodeHistograms.size();scope++){
+	  const WebResponseHistogram &h=(scope<0) ? all : sc.nodeHistograms[scope];
+	  for(uint32_t i=0;i<percentiles.size();i++){
+		  w.AddInt64(percentileTable,0,scope);
+		  w.AddDouble(percentileTable,1,percentiles[i]);
+		  w.AddDouble(percentileTable,2,h.GetQuantile(percentiles[i]/100));
+		  w.EndRow(percentileTable);
+	  }
+	  std::vector<WebResponseHistogram::CdfPoint> cdf=h.GetCdf();
+	  for(uint32_t i=0;i<cdf.size();i++){
+		  w.AddInt64(cdfTable,0,scope);
+		  w.AddDouble(cdfTable,1,cdf[i].value);
+		  w.AddDouble(cdfTable,2,cdf[i].cumulative);
+		  w.EndRow(cdfTable);
+	  }
+  }
+
+  uint32_t flows=w.AddTable("flows");
+  w.AddColumn(flows,"flow",WebResultFile::UINT64);
+  w.AddColumn(flows,"node",WebResultFile::UINT64);
+  w.AddColumn(flows,"browser",WebResultFile::UINT64);
+  w.AddColumn(flows,"pages",WebResultFile::UINT64);
+  w.AddColumn(flows,"meanResponseTime",WebResultFile::DOUBLE);
+  for(uint32_t i=0;i<sc.pageSinks.size();i++){
+	  w.AddUint64(flows,0,i);
+	  w.AddUint64(flows,1,i/cfg.numSourceFlows);
+	  w.AddUint64(flows,2,i%cfg.numSourceFlows);
+	  w.AddUint64(flows,3,sc.pageSinks[i].pages);
+	  w.AddDouble(flows,4,sc.pageSinks[i].pages ? sc.pageSinks[i].responseTimeSum/sc.pageSinks[i].pages : 0.0);
+	  w.EndRow(flows);
+  }
+
+  if(cfg.rawSamples){
+	  uint32_t pages=w.AddTable("responseTimes");
+	  w.AddColumn(pages,"flow",WebResultFile::UINT64);
+	  w.AddColumn(pages,"requestStart",WebResultFile::TIME);
+	  w.AddColumn(pages,"responseTime",WebResultFile::TIME);
+	  for(uint32_t i=0;i<sc.sourceApps.GetN();i++){
+		  Ptr<TcpWebClient> source1 = DynamicCast<TcpWebClient>(sc.sourceApps.Get(i));
+		  const std::vector<RequestDataStruct> &responseTimes=source1->getResponseTimes();
+		  for(uint32_t j=0;j<responseTimes.size();j++){
+			  if(responseTimes[j].requestStart<cfg.warmup)
+				  continue;
+			  w.AddUint64(pages,0,i);
+			  w.AddTime(pages,1,responseTimes[j].requestStart);
+			  w.AddTime(pages,2,responseTimes[j].requestExecutionTime);
+			  w.EndRow(pages);
+		  }
+	  }
+  }
+  w.Close();
+}
+
+static std::vector<double>
+ParsePercentiles (const std::string &list)
+{
+  std::vector<double> percentiles;
+  std::istringstream percentileList(list);
+  std::string p;
+  while(std::getline(percentileList,p,',')){
+	  if(p!="")
+		  percentiles.push_back(atof(p.c_str()));
+  }
+  return percentiles;
+}
+
+//prints the global percentiles and writes the CDF file, returns the global histogram
+//(the merge of the client nodes')
+static WebResponseHistogram
+WriteHistogramSummary (const P4Config &cfg, const std::vector<WebResponseHistogram> &nodeHistograms)
+{
+  std::vector<double> percentiles=ParsePercentiles(cfg.percentiles);
+  WebResponseHistogram all;
+  for(uint32_t i=0;i<nodeHistograms.size();i++){
+	  all.Merge(nodeHistograms[i]);
+  }
+  std::cerr << "pages," << all.GetCount();
+  for(uint32_t i=0;i<percentiles.size();i++){
+	  std::cerr << ",p" << percentiles[i] << "," << all.GetQuantile(percentiles[i]/100);
+  }
+  std::cerr << std::endl;
+  if(cfg.cdf!=""){
+	  std::ofstream cdfOUT(cfg.cdf.c_str());
+	  WriteHistogram(cdfOUT,"all",all,percentiles);
+	  for(uint32_t i=0;i<nodeHistograms.size();i++){
+		  std::ostringstream scope;
+		  scope << i;
+		  WriteHistogram(cdfOUT,scope.str(),nodeHistograms[i],percentiles);
+	  }
+  }
+  return all;
+}
+
+//appends one line of wall clock per phase, event rate and memory of a single run
+static void
+WriteProfile (const P4Config &cfg, const P4Scenario &sc, double wallSeconds)
+{
+  bool exists=std::ifstream(cfg.profile.c_str()).good();
+  std::ofstream profileOUT(cfg.profile.c_str(), std::ios::app);
+  if(!exists){
+	  profileOUT << "browsers,nNodes,nFlows,routing,simulatedSeconds,wallSeconds,simSecondsPerWallSecond,events,"
+			  << "eventsPerWallSecond,peakRssKb,topologySeconds,routingSeconds,installSeconds,runSeconds,outputSeconds" << std::endl;
+  }
+  double simulated=Simulator::Now().GetSeconds();
+  uint64_t events=WebCountingScheduler::GetProcessed();
+  profileOUT << sc.sourceApps.GetN() << "," << sc.clientNodes.GetN() << "," << cfg.numSourceFlows << "," << cfg.routing << ","
+		  << simulated << "," << wallSeconds << "," << simulated/wallSeconds << "," << events << ","
+		  << events/sc.runSeconds << "," << PeakRssKb() << "," << sc.topologySeconds << "," << sc.routingSeconds << ","
+		  << sc.installSeconds << "," << sc.runSeconds << "," << sc.outputSeconds << std::endl;
+}
+
+//prints the detector and percentile summaries and writes the CDFs and, if wanted, every reported page
+static void
+WriteResults (const P4Config &cfg, const P4Scenario &sc)
+{
+  std::cerr << "simulatedTime," << Simulator::Now().GetSeconds() << ",steadyState," << sc.detector->IsConverged()
+		  << ",batches," << sc.detector->GetNBatches()
+		  << ",meanResponseTime," << sc.detector->GetResponseTimeMean() << ",+-," << sc.detector->GetResponseTimeHalfWidth()
+		  << ",throughputBps," << sc.detector->GetThroughputMean() << ",+-," << sc.detector->GetThroughputHalfWidth() << std::endl;
+  sc.queueRecorder->Close();
+  std::cerr << "queue,enqueues," << sc.queueRecorder->GetEnqueues() << ",earlyDrops," << sc.queueRecorder->GetEarlyDrops()
+		  << ",forcedDrops," << sc.queueRecorder->GetForcedDrops()
+		  << ",maxBytes," << sc.queueRecorder->GetMaxBytes() << ",timeAverageBytes," << sc.queueRecorder->GetTimeAverageBytes() << std::endl;
+  std::cerr << "routing," << cfg.routing << ",buildSeconds," << sc.buildSeconds << ",routingSeconds," << sc.routingSeconds
+		  << ",routingRssKb," << sc.routingRssKb << ",routes," << sc.routes << ",peakRssKb," << PeakRssKb() << std::endl;
+  uint64_t poolHits=0, poolMisses=0;
+  for(uint32_t i=0;i<sc.sinkApps.GetN();i++){
+	  Ptr<TcpWebServer> server=DynamicCast<TcpWebServer>(sc.sinkApps.Get(i));
+	  poolHits+=server->GetPoolHits();
+	  poolMisses+=server->GetPoolMisses();
+  }
+  std::cerr << "pool,serverHits," << poolHits << ",serverMisses," << poolMisses << std::endl;
+  uint64_t socketsCreated=0, socketsReleased=0, socketsReclaimed=0, factoryLookups=0, socketsWaiting=0;
+  for(uint32_t i=0;i<sc.clientNodes.GetN();i++){
+	  Ptr<WebSocketPool> sockets=sc.clientNodes.Get(i)->GetObject<WebSocketPool>();
+	  if(!sockets)
+		  continue;
+	  socketsCreated+=sockets->GetCreated();
+	  socketsReleased+=sockets->GetReleased();
+	  socketsReclaimed+=sockets->GetReclaimed();
+	  factoryLookups+=sockets->GetFactoryLookups();
+	  socketsWaiting+=sockets->GetNWaiting();
+  }
+  std::cerr << "socketPool,created," << socketsCreated << ",factoryLookups," << factoryLookups
+		  << ",released," << socketsReleased << ",reclaimed," << socketsReclaimed << ",waiting," << socketsWaiting << std::endl;
+  if(cfg.objects>0){
+	  //how much of the servers' load the 1% most popular objects of their catalogs draw
+	  uint64_t requests=0, distinct=0, top=0, catalogBytes=0;
+	  uint32_t topRanks=std::max((uint32_t)1,cfg.objects/100);
+	  for(uint32_t i=0;i<sc.sinkApps.GetN();i++){
+		  Ptr<TcpWebServer> server=DynamicCast<TcpWebServer>(sc.sinkApps.Get(i));
+		  const std::vector<uint32_t> &counts=server->GetObjectRequests();
+		  catalogBytes+=server->GetCatalog()->GetMemoryBytes();
+		  for(uint32_t r=0;r<counts.size();r++){
+			  requests+=counts[r];
+			  distinct+=counts[r]>0;
+			  if(r<topRanks)
+				  top+=counts[r];
+		  }
+	  }
+	  std::cerr << "objects,perServer," << cfg.objects << ",zipfAlpha," << cfg.zipfAlpha << ",catalogBytes," << catalogBytes
+			  << ",serverRequests," << requests << ",distinct," << distinct
+			  << ",top1PercentShare," << (requests ? (double)top/requests : 0.0) << std::endl;
+  }
+  std::cerr << "objectTimes,smallBytes," << cfg.smallObject
+		  << ",small," << sc.objectSink.small.GetCount() << ",mean," << sc.objectSink.small.GetMean()
+		  << ",p50," << sc.objectSink.small.GetQuantile(0.5) << ",p99," << sc.objectSink.small.GetQuantile(0.99)
+		  << ",large," << sc.objectSink.large.GetCount() << ",mean," << sc.objectSink.large.GetMean()
+		  << ",p50," << sc.objectSink.large.GetQuantile(0.5) << ",p99," << sc.objectSink.large.GetQuantile(0.99) << std::endl;
+  if(cfg.serverScheduler!="none"){
+	  uint64_t quanta=0;
+	  uint32_t maxResponses=0;
+	  for(uint32_t i=0;i<sc.sinkApps.GetN();i++){
+		  Ptr<TcpWebServer> server=DynamicCast<TcpWebServer>(sc.sinkApps.Get(i));
+		  quanta+=server->GetQuanta();
+		  maxResponses=std::max(maxResponses,server->GetMaxResponses());
+	  }
+	  std::cerr << "scheduler," << cfg.serverScheduler << ",quantum," << cfg.schedulerQuantum
+			  << ",serviceRateMbps," << cfg.serverRate << ",quanta," << quanta << ",maxResponses," << maxResponses << std::endl;
+  }
+  if(sc.compression){
+	  //what the servers saved on the bottleneck and what it cost their workers
+	  uint64_t responses=0;
+	  uint64_t identityBytes=0;
+	  uint64_t encodedBytes=0;
+	  double cpuSeconds=0;
+	  for(uint32_t i=0;i<sc.sinkApps.GetN();i++){
+		  Ptr<TcpWebServer> server=DynamicCast<TcpWebServer>(sc.sinkApps.Get(i));
+		  responses+=server->GetCompressedResponses();
+		  identityBytes+=server->GetIdentityBytes();
+		  encodedBytes+=server->GetEncodedBytes();
+		  cpuSeconds+=server->GetCompressionTime().GetSeconds();
+	  }
+	  std::cerr << "compression,responses," << responses << ",identityBytes," << identityBytes
+			  << ",encodedBytes," << encodedBytes
+			  << ",ratio," << (identityBytes ? (double)encodedBytes/identityBytes : 1.0)
+			  << ",cpuSeconds," << cpuSeconds
+			  << ",cpuUtilization," << cpuSeconds/sc.sinkApps.GetN()/cfg.simTime << std::endl;
+  }
+  if(sc.proxy){
+	  const WebObjectCache &cache=sc.proxy->GetCache();
+	  uint64_t lookups=sc.proxy->GetHits()+sc.proxy->GetMisses();
+	  std::cerr << "proxy,policy," << cfg.proxyPolicy << ",cacheBytes," << cache.GetCapacity()
+			  << ",hits," << sc.proxy->GetHits() << ",misses," << sc.proxy->GetMisses()
+			  << ",uncacheable," << sc.proxy->GetUncacheable()
+			  << ",hitRate," << (lookups ? (double)sc.proxy->GetHits()/lookups : 0.0)
+			  << ",hitBytes," << sc.proxy->GetHitBytes() << ",originBytes," << sc.proxy->GetOriginBytes()
+			  << ",objects," << cache.GetNObjects() << ",bytes," << cache.GetBytes()
+			  << ",evictions," << cache.GetEvictions() << std::endl;
+  }
+  if(TcpWebCounters::IsEnabled()){
+	  for(uint32_t a=0;a<TcpWebCounters::N_APPS;a++){
+		  std::cerr << "counters," << TcpWebCounters::GetAppName((TcpWebCounters::App)a);
+		  for(uint32_t c=0;c<TcpWebCounters::N_COUNTERS;c++){
+			  std::cerr << "," << TcpWebCounters::GetCounterName((TcpWebCounters::Counter)c)
+					  << "," << TcpWebCounters::Get((TcpWebCounters::App)a,(TcpWebCounters::Counter)c);
+		  }
+		  std::cerr << std::endl;
+	  }
+  }
+  std::vector<double> percentiles=ParsePercentiles(cfg.percentiles);
+  WebResponseHistogram all=WriteHistogramSummary(cfg,sc.nodeHistograms);
+  if(cfg.out!=""){
+	  WriteBinaryResults(cfg,sc,all,percentiles);
+  }
+  if(!cfg.rawSamples)
+	  return;
+  if(cfg.csv=="" && cfg.out==""){
+	  for(uint32_t i=0;i<sc.sourceApps.GetN();i++){
 		  //print out the number of received bytes
-		  Ptr<TcpWebClient> source1 = DynamicCast<TcpWebClient>(sourceApps.Get(i));
+		  Ptr<TcpWebClient> source1 = DynamicCast<TcpWebClient>(sc.sourceApps.Get(i));
 		  std::vector<RequestDataStruct> responseTimes=source1->getResponseTimes();
 		  //std::cout << "Response Time for Flow " << i <<std::endl;
 		  for(uint32_t j=0;j<responseTimes.size();j++){
+			  if(responseTimes[j].requestStart<cfg.warmup)
+				  continue;
 			  std::cout << "Request Start Time," <<  responseTimes[j].requestStart << ",";
 			  std::cout << "Request Execution Time," << responseTimes[j].requestExecutionTime << std::endl;
 		  }
 	  }
   }
-  else{
-	  for(uint32_t i=0;i<sourceApps.GetN();i++){
-		  std::ofstream fileOUT(csv.c_str(), std::ios::app);
+  else if(cfg.csv!=""){
+	  std::ofstream fileOUT(cfg.csv.c_str(), std::ios::app);
+	  for(uint32_t i=0;i<sc.sourceApps.GetN();i++){
 		  //print out the number of received bytes
-		  Ptr<TcpWebClient> source1 = DynamicCast<TcpWebClient>(sourceApps.Get(i));
+		  Ptr<TcpWebClient> source1 = DynamicCast<TcpWebClient>(sc.sourceApps.Get(i));
 		  std::vector<RequestDataStruct> responseTimes=source1->getResponseTimes();
 		  //fileOUT << "Response Time for Flow " << i << std::endl;
 		  for(uint32_t j=0;j<responseTimes.size();j++){
+			  if(responseTimes[j].requestStart<cfg.warmup)
+				  continue;
 			  fileOUT << responseTimes[j].requestStart << ",";
 			  fileOUT << responseTimes[j].requestExecutionTime << std::endl;
 		  }
 	  }
   }
+}
+
+//one short run on an unconstrained bottleneck, returns the offered load in bits/s
+static double
+RunPilot (P4Config cfg, uint32_t numSourceFlows)
+{
+  cfg.numSourceFlows=numSourceFlows;
+  cfg.bottleneckRate=PILOT_BOTTLENECK_RATE;
+  cfg.isDropTail=true;
+  cfg.aqm="";
+  cfg.simTime=cfg.pilotTime;
+  cfg.targetPrecision=0;
+  //measure after the browsers ramped up
+  if(cfg.warmup<=0)
+	  cfg.warmup=cfg.pilotTime/4;
+  P4Scenario sc;
+  BuildScenario(cfg,sc);
+  Simulator::Stop(Seconds(cfg.simTime));
+  Simulator::Run();
+  double offered=sc.detector->GetThroughputMean();
+  Simulator::Destroy();
+  std::cerr << "pilot,nNodes," << cfg.numNodes << ",nFlows," << numSourceFlows
+		  << ",offeredLoadBps," << offered << std::endl;
+  return offered;
+}
+
+//searches nFlows (browsers per node, nNodes fixed) whose offered load is calibrate*bottleneckRate
+//using secant steps on pilot runs, starting from a linear (per browser) estimate
+static void
+Calibrate (P4Config cfg)
+{
+  double target=cfg.calibrate*cfg.bottleneckRate*1000000.0;
+  uint32_t n0=std::max(cfg.numSourceFlows,(uint32_t)1);
+  double load0=RunPilot(cfg,n0);
+  NS_ABORT_MSG_IF(load0<=0,"pilot run carried no traffic, increase --pilotTime or --nFlows");
+  double perBrowser=load0/(n0*cfg.numNodes);
+  std::cerr << "perBrowserLoadBps," << perBrowser << std::endl;
+  uint32_t n1=std::max((uint32_t)1,(uint32_t)(target/(perBrowser*cfg.numNodes)+0.5));
+  double load1=(n1==n0) ? load0 : RunPilot(cfg,n1);
+  for(uint32_t iter=0;iter<8 && n1!=n0;iter++){
+	  if(std::fabs(load1-target)<=cfg.calibrationTolerance*target)
+		  break;
+	  double slope=(load1-load0)/((double)n1-(double)n0);
+	  if(slope<=0)
+		  slope=perBrowser*cfg.numNodes;
+	  double next=n1+(target-load1)/slope;
+	  uint32_t n2=std::max((uint32_t)1,(uint32_t)(next+0.5));
+	  n0=n1;
+	  load0=load1;
+	  n1=n2;
+	  if(n1==n0)
+		  break;
+	  load1=RunPilot(cfg,n1);
+  }
+  std::cout << "calibration,targetUtilization," << cfg.calibrate << ",nNodes," << cfg.numNodes << ",nFlows," << n1
+		  << ",totalBrowsers," << n1*cfg.numNodes << ",offeredLoadBps," << load1
+		  << ",utilization," << load1/(cfg.bottleneckRate*1000000.0) << std::endl;
+  std::cout << "--nNodes=" << cfg.numNodes << " --nFlows=" << n1 << " --bottleneckRate=" << cfg.bottleneckRate << std::endl;
+}
+
+//name of replication k's copy of an output file: run.wrb -> run.rep<k>.wrb
+static std::string
+ReplicationName (const std::string &name, uint32_t k)
+{
+  std::ostringstream tag;
+  tag << ".rep" << k;
+  std::string::size_type dot=name.rfind('.');
+  std::string::size_type slash=name.rfind('/');
+  if(dot==std::string::npos || (slash!=std::string::npos && dot<slash))
+	  return name+tag.str();
+  return name.substr(0,dot)+tag.str()+name.substr(dot);
+}
+
+//replication k in a forked child: either a whole run with its own run number (build) or, after a shared
+//warm-up, the measurement phase with a new run number for the browsers' streams; writes this replication's
+//outputs and hands its histograms (and raw pages) to the parent
+static void
+RunForkedReplication (P4Config cfg, P4Scenario &sc, bool build, uint32_t k, uint64_t run, const std::string &handover)
+{
+  RngSeedManager::SetRun(run);
+  if(build){
+	  BuildScenario(cfg,sc);
+  }
+  else{
+	  TcpWebClientHelper reseed(Address(),80);
+	  reseed.AssignStreams(sc.clientNodes,CLIENT_STREAM_BASE,cfg.numSourceFlows);
+  }
+  //opened in the child so that every replication has its own file
+  if(cfg.queueTrace!="" && !sc.queueRecorder->Open(ReplicationName(cfg.queueTrace,k))){
+	  NS_FATAL_ERROR("cannot open " << ReplicationName(cfg.queueTrace,k));
+  }
+  Simulator::Stop(Seconds(cfg.simTime)-Simulator::Now());
+  Simulator::Run();
+
+  //raw pages go to the parent unless they only belong in the binary file
+  bool rawToParent=cfg.rawSamples && (cfg.csv!="" || cfg.out=="");
+  cfg.csv=rawToParent ? handover+".csv" : "";
+  cfg.cdf="";
+  if(cfg.out!="")
+	  cfg.out=ReplicationName(cfg.out,k);
+  std::cerr << "replication," << k << ",run," << run << std::endl;
+  WriteResults(cfg,sc);
+  std::ofstream handOUT(handover.c_str());
+  handOUT << "replication " << k << " " << run << " " << sc.detector->GetResponseTimeMean() << " "
+		  << sc.detector->GetThroughputMean() << " " << sc.nodeHistograms.size() << std::endl;
+  for(uint32_t i=0;i<sc.nodeHistograms.size();i++){
+	  sc.nodeHistograms[i].Serialize(handOUT);
+  }
+  handOUT.close();
+  Simulator::Destroy();
+}
+
+//runs n replications in forked children (at most forkWorkers at a time), each with its own run number.
+//Independent replications build the whole scenario in the child (RngRun+k); otherwise the scenario is
+//built and warmed up once and the children only run the measurement phase (RngRun+1+k).
+//The parent merges the histograms and raw pages and reports 95% confidence intervals over the replications.
+static void
+RunReplications (const P4Config &cfg, uint32_t n, bool independent)
+{
+  P4Scenario sc;
+  if(!independent){
+	  NS_ABORT_MSG_IF(cfg.warmup<=0,"--forkReplications needs a --warmup to fork at");
+	  BuildScenario(cfg,sc);
+	  Simulator::Stop(Seconds(cfg.warmup));
+	  Simulator::Run();
+	  std::cerr << "warmedUp," << Simulator::Now().GetSeconds() << std::endl;
+  }
+
+  uint64_t baseRun=RngSeedManager::GetRun();
+  uint32_t workers=cfg.forkWorkers;
+  if(workers==0)
+	  workers=std::max((long)1,sysconf(_SC_NPROCESSORS_ONLN));
+  std::vector<std::string> handovers(n);
+  std::vector<pid_t> pids(n,0);
+  std::vector<bool> failed(n,false);
+  uint32_t next=0;
+  uint32_t running=0;
+  while(next<n || running>0){
+	  if(next<n && running<workers){
+		  char tmpl[]="/tmp/p4forkXXXXXX";
+		  int fd=mkstemp(tmpl);
+		  NS_ABORT_MSG_IF(fd<0,"cannot create a replication hand-over file");
+		  close(fd);
+		  handovers[next]=tmpl;
+		  std::cout.flush();
+		  std::cerr.flush();
+		  pid_t pid=fork();
+		  NS_ABORT_MSG_IF(pid<0,"fork failed");
+		  if(pid==0){
+			  RunForkedReplication(cfg,sc,independent,next,independent ? baseRun+next : baseRun+1+next,handovers[next]);
+			  exit(0);
+		  }
+		  pids[next]=pid;
+		  next++;
+		  running++;
+		  continue;
+	  }
+	  int status;
+	  pid_t pid=wait(&status);
+	  if(pid<0)
+		  break;
+	  for(uint32_t k=0;k<next;k++){
+		  if(pids[k]==pid){
+			  failed[k]=!WIFEXITED(status) || WEXITSTATUS(status)!=0;
+			  running--;
+		  }
+	  }
+  }
+
+  std::vector<double> percentiles=ParsePercentiles(cfg.percentiles);
+  Average<double> meanResponseTimes;
+  Average<double> throughputs;
+  std::vector< Average<double> > percentileValues(percentiles.size());
+  std::vector<WebResponseHistogram> nodeHistograms(cfg.numNodes);
+  std::ofstream fileOUT;
+  if(cfg.csv!="")
+	  fileOUT.open(cfg.csv.c_str(), std::ios::app);
+  for(uint32_t k=0;k<n;k++){
+	  std::ifstream handIN(handovers[k].c_str());
+	  std::string tag;
+	  uint32_t replication, nNodes=0;
+	  uint64_t run;
+	  double meanResponseTime, throughput;
+	  bool ok=!failed[k] && (handIN >> tag >> replication >> run >> meanResponseTime >> throughput >> nNodes)
+			  && nNodes==nodeHistograms.size();
+	  WebResponseHistogram replicationAll;
+	  for(uint32_t i=0;ok && i<nNodes;i++){
+		  WebResponseHistogram h;
+		  ok=h.Deserialize(handIN);
+		  nodeHistograms[i].Merge(h);
+		  replicationAll.Merge(h);
+	  }
+	  if(!ok){
+		  std::cerr << "replication," << k << ",failed" << std::endl;
+	  }
+	  else{
+		  //one sample per replication for the confidence intervals
+		  meanResponseTimes.Update(replicationAll.GetMean());
+		  throughputs.Update(throughput);
+		  for(uint32_t i=0;i<percentiles.size();i++){
+			  percentileValues[i].Update(replicationAll.GetQuantile(percentiles[i]/100));
+		  }
+		  std::cerr << "replication," << k << ",run," << run << ",meanResponseTime," << replicationAll.GetMean()
+				  << ",throughputBps," << throughput << std::endl;
+		  std::ifstream rawIN((handovers[k]+".csv").c_str());
+		  std::string line;
+		  while(std::getline(rawIN,line)){
+			  if(cfg.csv!=""){
+				  fileOUT << line << std::endl;
+			  }
+			  else{
+				  std::string::size_type comma=line.find(',');
+				  std::cout << "Request Start Time," <<  line.substr(0,comma) << ",";
+				  std::cout << "Request Execution Time," << line.substr(comma+1) << std::endl;
+			  }
+		  }
+	  }
+	  remove(handovers[k].c_str());
+	  remove((handovers[k]+".csv").c_str());
+  }
+  WriteHistogramSummary(cfg,nodeHistograms);
+  std::cerr << "replications," << meanResponseTimes.Count()
+		  << ",meanResponseTime," << meanResponseTimes.Mean() << ",+-," << WebSteadyStateDetector::HalfWidth(meanResponseTimes)
+		  << ",throughputBps," << throughputs.Mean() << ",+-," << WebSteadyStateDetector::HalfWidth(throughputs);
+  for(uint32_t i=0;i<percentiles.size();i++){
+	  std::cerr << ",p" << percentiles[i] << "," << percentileValues[i].Mean() << ",+-," << WebSteadyStateDetector::HalfWidth(percentileValues[i]);
+  }
+  std::cerr << std::endl;
+  if(cfg.cdf!=""){
+	  //mean over replications and 95% half-width (rows kind,scope,x,y like the CDF)
+	  std::ofstream cdfOUT(cfg.cdf.c_str(), std::ios::app);
+	  cdfOUT << "replications,all," << meanResponseTimes.Count() << "," << meanResponseTimes.Count() << std::endl;
+	  cdfOUT << "meanResponseTimeCi,all," << meanResponseTimes.Mean() << "," << WebSteadyStateDetector::HalfWidth(meanResponseTimes) << std::endl;
+	  for(uint32_t i=0;i<percentiles.size();i++){
+		  cdfOUT << "percentileMean,all," << percentiles[i] << "," << percentileValues[i].Mean() << std::endl;
+		  cdfOUT << "percentileHalfWidth,all," << percentiles[i] << "," << WebSteadyStateDetector::HalfWidth(percentileValues[i]) << std::endl;
+	  }
+  }
+  if(!independent)
+	  Simulator::Destroy();
+}
+
+int 
+main (int argc, char *argv[])
+{
+  P4Config cfg;
+  cfg.verbose = false;
+  cfg.minTh=5;
+  cfg.maxTh=15;
+  cfg.numSourceFlows=2;
+  cfg.weightFactor=.002;
+  cfg.maxDropProb=50;
+  cfg.queueSize=640000;
+  cfg.bottleneckRate=100;
+  cfg.recieverWindowSize=32000;
+  cfg.linkDelay=.0005;
+  cfg.isDropTail=true;
+  cfg.aqm="";
+  cfg.topology="";
+  cfg.routing="global";
+  cfg.profile="";
+  cfg.eventLog="";
+  cfg.objects=0;
+  cfg.zipfAlpha=0.8;
+  cfg.proxyCache=0;
+  cfg.proxyPolicy="LRU";
+  cfg.serverScheduler="none";
+  cfg.schedulerQuantum=1460;
+  cfg.serverRate=100;
+  cfg.smallObject=10000;
+  cfg.compression=false;
+  cfg.compressionCpu=20;
+  cfg.numNodes=1;
+  cfg.csv="";
+  cfg.simTime=END_TIME;
+  cfg.warmup=0;
+  cfg.targetPrecision=0;
+  cfg.batchInterval=10;
+  cfg.minBatches=10;
+  cfg.calibrate=0;
+  cfg.pilotTime=200;
+  cfg.calibrationTolerance=0.02;
+  cfg.cdf="";
+  cfg.percentiles="50,90,95,99,99.9";
+  cfg.rawSamples=true;
+  cfg.out="";
+  cfg.forkReplications=0;
+  cfg.replications=0;
+  cfg.forkWorkers=0;
+  cfg.queueTrace="";
+  cfg.queueSampleInterval=0;
+  //add command line parameters
+  CommandLine cmd;
+  cmd.AddValue ("minTh", "Queue length threshold for triggering probabilistic drops", cfg.minTh);
+  cmd.AddValue ("maxTh", "Queue length threshold for triggering forced drops.", cfg.maxTh);
+  cmd.AddValue ("weightFactor", "Weighting factor for the average queue length computation.",cfg.weightFactor);
+  cmd.AddValue ("maxDropProb", "The maximum probability of performing an early drop as percent (50=50%).",cfg.maxDropProb);
+  cmd.AddValue ("queueSize", "Queue Size at Bottleneck Link", cfg.queueSize);
+  cmd.AddValue ("verbose", "Enable Informational Logging", cfg.verbose);
+  cmd.AddValue("nFlows","Number of Flows on one node from source -> Receiver",cfg.numSourceFlows);
+  cmd.AddValue("isDropTail","Boolean to toggle between Droptail and Red (True=DropTail)",cfg.isDropTail);
+  cmd.AddValue("aqm","Queue of the bottleneck link only, name[:key=value,...] with name droptail, red, codel or a "
+		  "Queue TypeId (e.g. red:MinTh=45000,MaxTh=135000); other links become DropTail. Overrides isDropTail",cfg.aqm);
+  cmd.AddValue("topology","Build this topology description (WebTopologyHelper) instead of the dumbbells; "
+		  "$bottleneckRate and $linkDelays are the options below, the link named bottleneck is recorded",cfg.topology);
+  cmd.AddValue("routing","global (tables on every node), nix (nix vectors on demand) or static (routes of a tree "
+		  "topology such as the dumbbells); the build and routing time and memory are printed",cfg.routing);
+  cmd.AddValue("profile","Append the run's wall time per phase, simulated seconds per wall second, scheduler events "
+		  "and peak memory to this csv (one line per run, header when the file is new)",cfg.profile);
+  cmd.AddValue("eventLog","Write the client and server events compiled in (TCPWEB_LOG_LEVEL) to this "
+		  "binary result file, table events",cfg.eventLog);
+  cmd.AddValue("objects","Every server gets a catalog of this many objects, each with a fixed size, that the "
+		  "secondary requests of its browsers ask for by Zipf popularity (0=sizes drawn per request)",cfg.objects);
+  cmd.AddValue("zipfAlpha","Zipf exponent of the object popularity",cfg.zipfAlpha);
+  cmd.AddValue("proxyCache","Put a caching TcpWebProxy of this many bytes on the client side end of the bottleneck; "
+		  "the browsers connect to it, the servers are its origins (needs --objects)",cfg.proxyCache);
+  cmd.AddValue("proxyPolicy","Cache replacement of the proxy, LRU or LFU",cfg.proxyPolicy);
+  cmd.AddValue("serverScheduler","none (servers hand each response whole to TCP), or the order the servers hand "
+		  "responses to TCP in quanta: fifo, srpt (fewest bytes left first) or fair (round robin)",cfg.serverScheduler);
+  cmd.AddValue("schedulerQuantum","Bytes of a response a server scheduler hands to TCP at once",cfg.schedulerQuantum);
+  cmd.AddValue("serverRate","Mbps a server scheduler hands quanta to TCP at (0=as fast as the send buffers take them)",cfg.serverRate);
+  cmd.AddValue("smallObject","Responses up to this many bytes count as small objects in the objectTimes line",cfg.smallObject);
+  cmd.AddValue("compression","Servers compress the responses by content type (WebCompressionModel), needs a --serverScheduler",cfg.compression);
+  cmd.AddValue("compressionCpu","Nanoseconds of server worker time per byte compressed",cfg.compressionCpu);
+  cmd.AddValue("bottleneckRate","Rate of bottleneckLink in Mbps",cfg.bottleneckRate);
+  cmd.AddValue ("receiverWindowSize", "TCP Advertised Reciever Window Size", cfg.recieverWindowSize);
+  cmd.AddValue("linkDelays","Delays of all links in system in seconds",cfg.linkDelay);
+  cmd.AddValue("nNodes","Number of Nodes in the Simulation",cfg.numNodes);
+  cmd.AddValue("csv","Csv filename for run",cfg.csv);
+  cmd.AddValue("simTime","Simulated time in seconds",cfg.simTime);
+  cmd.AddValue("warmup","Pages started before this time (seconds) are not reported",cfg.warmup);
+  cmd.AddValue("targetPrecision","Stop once the 95% CI half-widths of response time and bottleneck throughput are "
+		  "below this fraction of their means (0=run to the end)",cfg.targetPrecision);
+  cmd.AddValue("batchInterval","Batch length in seconds for the steady state detector",cfg.batchInterval);
+  cmd.AddValue("minBatches","Batches needed before the steady state detector may stop the run",cfg.minBatches);
+  cmd.AddValue("calibrate","Instead of a run, search nFlows for this bottleneck utilization (0.9=90%) with pilot runs",cfg.calibrate);
+  cmd.AddValue("pilotTime","Simulated seconds of one calibration pilot run",cfg.pilotTime);
+  cmd.AddValue("calibrationTolerance","Accepted relative error of the calibrated offered load",cfg.calibrationTolerance);
+  cmd.AddValue("cdf","File for the response time CDF points and percentiles, global and per client node",cfg.cdf);
+  cmd.AddValue("percentiles","Comma separated response time percentiles to report",cfg.percentiles);
+  cmd.AddValue("rawSamples","Also write every page (start,response time) to csv/stdout",cfg.rawSamples);
+  cmd.AddValue("out","Columnar binary result file (.wrb) with the run configuration, summaries and pages",cfg.out);
+  cmd.AddValue("forkReplications","Build and warm up once, then fork this many replications that each run the "
+		  "measurement phase with their own RngRun (RngRun+1+k)",cfg.forkReplications);
+  cmd.AddValue("replications","Run this many independent replications (RngRun+k) in parallel processes and "
+		  "report 95% confidence intervals of the mean and percentile response times",cfg.replications);
+  cmd.AddValue("forkWorkers","Replications running at the same time (0=one per core)",cfg.forkWorkers);
+  cmd.AddValue("queueTrace","Record the bottleneck queue (length, average, drops) into this binary (.wrb) file",cfg.queueTrace);
+  cmd.AddValue("queueSampleInterval","Seconds between bottleneck queue records (0=every enqueue/dequeue)",cfg.queueSampleInterval);
+  cmd.Parse (argc,argv);
+
+  if (cfg.verbose)
+  {
+	  LogComponentEnable ("TcpWebClientApplication", LOG_LEVEL_FUNCTION);
+	  LogComponentEnable ("TcpWebServerApplication", LOG_LEVEL_FUNCTION);
+  }
+  NS_ABORT_MSG_IF(cfg.routing!="global" && cfg.routing!="nix" && cfg.routing!="static",
+		  "--routing must be global, nix or static");
+  NS_ABORT_MSG_IF(cfg.proxyPolicy!="LRU" && cfg.proxyPolicy!="LFU","--proxyPolicy must be LRU or LFU");
+  ParseScheduler(cfg.serverScheduler);
+  NS_ABORT_MSG_IF(cfg.compression && cfg.serverScheduler=="none",
+		  "--compression needs a --serverScheduler, its worker pays the compression time");
+  NS_ABORT_MSG_IF(cfg.proxyCache>0 && cfg.objects==0,"--proxyCache needs --objects, only known objects are cached");
+  if(cfg.topology!=""){
+	  //nNodes counts the client nodes of the description (calibration, histograms)
+	  WebTopologyHelper topology;
+	  topology.Load(cfg.topology);
+	  cfg.numNodes=topology.GetNClientNodes();
+  }
+  if(cfg.calibrate>0){
+	  Calibrate(cfg);
+	  return 0;
+  }
+  NS_ABORT_MSG_IF(cfg.forkReplications>0 && cfg.replications>0,"use either --forkReplications or --replications");
+  NS_ABORT_MSG_IF(cfg.profile!="" && (cfg.forkReplications>0 || cfg.replications>0),"--profile profiles single runs only");
+  NS_ABORT_MSG_IF(cfg.eventLog!="" && (cfg.forkReplications>0 || cfg.replications>0),"--eventLog logs single runs only");
+  if(cfg.forkReplications>0){
+	  RunReplications(cfg,cfg.forkReplications,false);
+	  return 0;
+  }
+  if(cfg.replications>0){
+	  RunReplications(cfg,cfg.replications,true);
+	  return 0;
+  }
+
+  if(cfg.profile!=""){
+	  //count the events from the first one on
+	  ObjectFactory scheduler("ns3::WebCountingScheduler");
+	  Simulator::SetScheduler(scheduler);
+  }
+  if(cfg.eventLog!=""){
+	  NS_ABORT_MSG_IF(TCPWEB_LOG_LEVEL<TCPWEB_LOG_LEVEL_EVENT,"--eventLog needs TCPWEB_LOG_LEVEL 1 or more");
+	  if(!WebEventLog::Open(cfg.eventLog)){
+		  NS_FATAL_ERROR("cannot open " << cfg.eventLog);
+	  }
+  }
+  double start=WallClock();
+  P4Scenario sc;
+  BuildScenario(cfg,sc);
+  if(cfg.queueTrace!="" && !sc.queueRecorder->Open(cfg.queueTrace)){
+	  NS_FATAL_ERROR("cannot open " << cfg.queueTrace);
+  }
+  Simulator::Stop(Seconds(cfg.simTime));
+  double runStart=WallClock();
+  Simulator::Run();
+  sc.runSeconds=WallClock()-runStart;
+  WriteResults(cfg,sc);
+  sc.outputSeconds=WallClock()-runStart-sc.runSeconds;
+  if(cfg.eventLog!=""){
+	  std::cerr << "eventLog," << cfg.eventLog << ",records," << WebEventLog::GetNRecords() << std::endl;
+	  WebEventLog::Close();
+  }
+  if(cfg.profile!=""){
+	  WriteProfile(cfg,sc,WallClock()-start);
+  }
   Simulator::Destroy();
   return 0;
 }
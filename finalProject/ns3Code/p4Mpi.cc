@@ -0,0 +1,372 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Distributed version of p4: the same two dumbbells joined by the bottleneck,
+ * partitioned over MPI ranks with ns-3's distributed simulator.
+ * The server dumbbell lives on the last rank, the client routers on rank 0 and
+ * the client leaves are spread over the remaining ranks, so the bottleneck
+ * (and any client leaf link leaving rank 0) is a cross-rank link whose delay
+ * is the lookahead. Node ids, addresses, start times and RNG streams are the
+ * same as in p4 for every rank count, so the results can be checked against a
+ * one rank run with --verify.
+ *
+ * mpirun -np 2 ./waf --run "scratch/p4Mpi --nNodes=7 --nFlows=458 --csv=MY.csv --verify=MY.digest"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mpi-interface.h"
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstring>
+
+#ifdef NS3_MPI
+#include <mpi.h>
+#endif
+
+#define END_TIME 2000.0
+//first stream of the per-browser block (start time generator uses stream 6110)
+#define CLIENT_STREAM_BASE 10000
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("P4MpiExample");
+
+//nodes and devices of one dumbbell, built like PointToPointDumbbellHelper
+//but with a system id for every node
+typedef struct
+{
+  NodeContainer routers;
+  NodeContainer leftLeaf;
+  NodeContainer rightLeaf;
+  NetDeviceContainer routerDevices;
+  NetDeviceContainer leftRouterDevices;
+  NetDeviceContainer leftLeafDevices;
+  NetDeviceContainer rightRouterDevices;
+  NetDeviceContainer rightLeafDevices;
+  Ipv4InterfaceContainer leftLeafInterfaces;
+  Ipv4InterfaceContainer rightLeafInterfaces;
+} Dumbbell;
+
+//creates the dumbbell in the same node/device/address order as PointToPointDumbbellHelper
+//so node ids and addresses match the serial p4 topology
+static void
+BuildDumbbell (Dumbbell &db, std::vector<uint32_t> leftRanks, uint32_t routerRank, std::vector<uint32_t> rightRanks,
+               PointToPointHelper leftHelper, PointToPointHelper rightHelper, PointToPointHelper bottleneckHelper)
+{
+  db.routers.Create (1, routerRank);
+  db.routers.Create (1, routerRank);
+  for (uint32_t i = 0; i < leftRanks.size (); i++)
+    {
+      db.leftLeaf.Create (1, leftRanks[i]);
+    }
+  for (uint32_t i = 0; i < rightRanks.size (); i++)
+    {
+      db.rightLeaf.Create (1, rightRanks[i]);
+    }
+  db.routerDevices = bottleneckHelper.Install (db.routers);
+  for (uint32_t i = 0; i < db.leftLeaf.GetN (); i++)
+    {
+      NetDeviceContainer c = leftHelper.Install (db.routers.Get (0), db.leftLeaf.Get (i));
+      db.leftRouterDevices.Add (c.Get (0));
+      db.leftLeafDevices.Add (c.Get (1));
+    }
+  for (uint32_t i = 0; i < db.rightLeaf.GetN (); i++)
+    {
+      NetDeviceContainer c = rightHelper.Install (db.routers.Get (1), db.rightLeaf.Get (i));
+      db.rightRouterDevices.Add (c.Get (0));
+      db.rightLeafDevices.Add (c.Get (1));
+    }
+}
+
+static void
+AssignDumbbellAddresses (Dumbbell &db, InternetStackHelper &stack, Ipv4AddressHelper leftIp,
+                         Ipv4AddressHelper rightIp, Ipv4AddressHelper routerIp)
+{
+  stack.Install (db.routers);
+  stack.Install (db.leftLeaf);
+  stack.Install (db.rightLeaf);
+  routerIp.Assign (db.routerDevices);
+  for (uint32_t i = 0; i < db.leftLeaf.GetN (); i++)
+    {
+      NetDeviceContainer ndc;
+      ndc.Add (db.leftLeafDevices.Get (i));
+      ndc.Add (db.leftRouterDevices.Get (i));
+      db.leftLeafInterfaces.Add (leftIp.Assign (ndc));
+      leftIp.NewNetwork ();
+    }
+  for (uint32_t i = 0; i < db.rightLeaf.GetN (); i++)
+    {
+      NetDeviceContainer ndc;
+      ndc.Add (db.rightLeafDevices.Get (i));
+      ndc.Add (db.rightRouterDevices.Get (i));
+      db.rightLeafInterfaces.Add (rightIp.Assign (ndc));
+      rightIp.NewNetwork ();
+    }
+}
+
+//order independent fingerprint of a set of response time records
+static uint64_t
+RecordHash (double start, double duration)
+{
+  uint64_t bits[2];
+  std::memcpy (&bits[0], &start, sizeof (double));
+  std::memcpy (&bits[1], &duration, sizeof (double));
+  uint64_t h = 1469598103934665603ULL;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      for (uint32_t b = 0; b < 8; b++)
+        {
+          h ^= (bits[i] >> (8 * b)) & 0xff;
+          h *= 1099511628211ULL;
+        }
+    }
+  return h;
+}
+
+int 
+main (int argc, char *argv[])
+{
+  bool verbose = false;
+  double minTh=5;
+  double maxTh=15;
+  uint32_t numSourceFlows=2;
+  double weightFactor=.002;
+  double maxDropProb=50;
+  uint32_t queueSize=640000;
+  uint64_t bottleneckRate=100;
+  uint32_t recieverWindowSize=32000;
+  double linkDelay=.0005;
+  std::string queueType="";
+  bool isDropTail=true;
+  uint32_t numNodes=1;
+  std::string csv="";
+  std::string verify="";
+  //add command line parameters
+  CommandLine cmd;
+  cmd.AddValue ("minTh", "Queue length threshold for triggering probabilistic drops", minTh);
+  cmd.AddValue ("maxTh", "Queue length threshold for triggering forced drops.", maxTh);
+  cmd.AddValue ("weightFactor", "Weighting factor for the average queue length computation.",weightFactor);
+  cmd.AddValue ("maxDropProb", "The maximum probability of performing an early drop as percent (50=50%).",maxDropProb);
+  cmd.AddValue ("queueSize", "Queue Size at Bottleneck Link", queueSize);
+  cmd.AddValue ("verbose", "Enable Informational Logging", verbose);
+  cmd.AddValue("nFlows","Number of Flows on one node from source -> Receiver",numSourceFlows);
+  cmd.AddValue("isDropTail","Boolean to toggle between Droptail and Red (True=DropTail)",isDropTail);
+  cmd.AddValue("bottleneckRate","Rate of bottleneckLink in Mbps",bottleneckRate);
+  cmd.AddValue ("receiverWindowSize", "TCP Advertised Reciever Window Size", recieverWindowSize);
+  cmd.AddValue("linkDelays","Delays of all links in system in seconds",linkDelay);
+  cmd.AddValue("nNodes","Number of Nodes in the Simulation",numNodes);
+  cmd.AddValue("csv","Csv filename for run (rank k > 0 writes <csv>.rank<k>)",csv);
+  cmd.AddValue("verify","Digest file: written if missing, otherwise the run is checked against it",verify);
+  cmd.Parse (argc,argv);
+
+#ifdef NS3_MPI
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DistributedSimulatorImpl"));
+  MpiInterface::Enable (&argc, &argv);
+  uint32_t rank = MpiInterface::GetSystemId ();
+  uint32_t size = MpiInterface::GetSize ();
+#else
+  NS_FATAL_ERROR ("p4Mpi needs ns-3 configured with --enable-mpi");
+  uint32_t rank = 0;
+  uint32_t size = 1;
+#endif
+
+  //get in terms of Mbps
+  bottleneckRate*=1000000;
+
+  //all values are inital defaults right now
+  if(isDropTail){
+	  queueType="ns3::DropTailQueue";
+	  Config::SetDefault("ns3::DropTailQueue::Mode",EnumValue(ns3::DropTailQueue::QUEUE_MODE_BYTES));
+	  Config::SetDefault("ns3::DropTailQueue::MaxBytes",UintegerValue(queueSize));
+
+  }
+  else{
+	  queueType="ns3::RedQueue";
+	  Config::SetDefault("ns3::RedQueue::Mode", EnumValue(ns3::RedQueue::QUEUE_MODE_BYTES));
+	  Config::SetDefault("ns3::RedQueue::MinTh", DoubleValue(minTh));
+	  Config::SetDefault("ns3::RedQueue::MaxTh",DoubleValue(maxTh));
+	  Config::SetDefault("ns3::RedQueue::QueueLimit",UintegerValue(queueSize));
+	  Config::SetDefault("ns3::RedQueue::QW",DoubleValue(weightFactor));
+	  Config::SetDefault("ns3::RedQueue::LInterm",DoubleValue(maxDropProb));
+  }
+  Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(ns3::TcpNewReno::GetTypeId()));
+  //Make sure packets lost bc of queues along the way not at hosts
+  Config::SetDefault("ns3::TcpSocket::SndBufSize",UintegerValue(0xffffffff));
+  Config::SetDefault("ns3::UdpSocket::RcvBufSize",UintegerValue(recieverWindowSize));
+  Config::SetDefault ("ns3::TcpSocketBase::WindowScaling", BooleanValue (false));
+
+  if (verbose)
+  {
+	  LogComponentEnable ("TcpWebClientApplication", LOG_LEVEL_FUNCTION);
+	  LogComponentEnable ("TcpWebServerApplication", LOG_LEVEL_FUNCTION);
+  }
+
+  //type of links in the topology
+  PointToPointHelper tenMbpsLink;
+  tenMbpsLink.SetDeviceAttribute ("DataRate", StringValue("10Mbps"));
+  tenMbpsLink.SetChannelAttribute ("Delay", TimeValue(Seconds(linkDelay)));
+  tenMbpsLink.SetQueue(queueType);
+  PointToPointHelper hundredMbpsLink;
+  hundredMbpsLink.SetDeviceAttribute("DataRate",StringValue("100Mbps"));
+  hundredMbpsLink.SetChannelAttribute("Delay",TimeValue(Seconds(linkDelay)));
+  hundredMbpsLink.SetQueue(queueType);
+  PointToPointHelper bottleNeckLink;
+  bottleNeckLink.SetDeviceAttribute("DataRate",DataRateValue(DataRate(bottleneckRate)));
+  bottleNeckLink.SetChannelAttribute("Delay",TimeValue(Seconds(linkDelay)));
+  bottleNeckLink.SetQueue(queueType);
+
+  //partition: server dumbbell on the last rank, client routers on rank 0,
+  //client leaves round robin over every rank but the server one (when there is more than one)
+  uint32_t serverRank=size-1;
+  uint32_t clientRanks=(size>1) ? size-1 : 1;
+  std::vector<uint32_t> clientLeafRanks;
+  for(uint32_t i=0;i<numNodes;i++){
+	  clientLeafRanks.push_back(i%clientRanks);
+  }
+  InternetStackHelper stack;
+  Dumbbell d;
+  BuildDumbbell(d,clientLeafRanks,0,std::vector<uint32_t>(1,0),tenMbpsLink,hundredMbpsLink,hundredMbpsLink);
+  AssignDumbbellAddresses(d,stack,Ipv4AddressHelper ("10.1.0.0", "255.255.255.0"),Ipv4AddressHelper ("10.3.0.0", "255.255.255.0"),
+  Ipv4AddressHelper ("10.5.0.0", "255.255.255.0"));
+
+  Dumbbell serverSide;
+  BuildDumbbell(serverSide,std::vector<uint32_t>(1,serverRank),serverRank,std::vector<uint32_t>(numNodes,serverRank),
+		  hundredMbpsLink,tenMbpsLink,hundredMbpsLink);
+  AssignDumbbellAddresses(serverSide,stack,Ipv4AddressHelper ("10.7.0.0", "255.255.255.0"),Ipv4AddressHelper ("10.9.0.0", "255.255.255.0"),
+  Ipv4AddressHelper ("10.11.0.0", "255.255.255.0"));
+
+  //the bottleneck crosses from rank 0 to the server rank; its delay is the lookahead
+  NodeContainer nodes;
+  nodes.Add(d.rightLeaf.Get(0));
+  nodes.Add(serverSide.leftLeaf.Get(0));
+  NetDeviceContainer devices;
+  devices = bottleNeckLink.Install(nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.6.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+  //applications only go on the nodes owned by this rank
+  uint16_t tcpStartSinkPort = 80;
+  ApplicationContainer sinkApps;
+  for(uint32_t i=0;i<serverSide.rightLeaf.GetN();i++){
+	  if(serverSide.rightLeaf.Get(i)->GetSystemId()!=rank)
+		  continue;
+	  TcpWebServerHelper server("ns3::TcpSocketFactory",InetSocketAddress(Ipv4Address::GetAny(),tcpStartSinkPort));
+	  ApplicationContainer sinkApp = server.Install(serverSide.rightLeaf.Get(i));
+	  sinkApp.Start(Seconds(0.0));
+	  sinkApp.Stop(Seconds (END_TIME));
+	  sinkApps.Add(sinkApp);
+  }
+  ApplicationContainer sourceApps;
+  RngSeedManager::SetSeed(11223344);
+  Ptr<UniformRandomVariable> randGenerator = CreateObject<UniformRandomVariable>();
+  randGenerator->SetAttribute("Stream",IntegerValue(6110));
+  randGenerator->SetAttribute("Min",DoubleValue(0.0));
+  randGenerator->SetAttribute("Max",DoubleValue(0.1));
+  for(uint32_t i=0;i<d.leftLeaf.GetN();i++)
+  {
+	  bool isLocal=d.leftLeaf.Get(i)->GetSystemId()==rank;
+	  TcpWebClientHelper source (Address(serverSide.rightLeafInterfaces.GetAddress(i)),tcpStartSinkPort);
+	  for(uint16_t j=0;j<numSourceFlows;j++){
+		  //every rank draws every start time so the sequence matches the serial run
+		  double startTime=randGenerator->GetValue();
+		  if(!isLocal)
+			  continue;
+		  ApplicationContainer sourceApp = source.Install(d.leftLeaf.Get(i));
+		  sourceApp.Start(Seconds(startTime));
+		  sourceApp.Stop(Seconds(END_TIME));
+		  sourceApps.Add(sourceApp);
+	  }
+	  if(isLocal)
+		  source.AssignStreams(NodeContainer(d.leftLeaf.Get(i)),CLIENT_STREAM_BASE,numSourceFlows);
+  }
+  //every rank holds the full topology so global routing is computed identically everywhere
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+  Simulator::Stop(Seconds(END_TIME));
+  Simulator::Run();
+
+  //write this rank's records and fold them into the digest
+  uint64_t localCount=0;
+  uint64_t localHash=0;
+  double localSum=0;
+  std::ofstream fileOUT;
+  if(csv!="" && sourceApps.GetN()>0){
+	  std::ostringstream name;
+	  name << csv;
+	  if(rank>0)
+		  name << ".rank" << rank;
+	  fileOUT.open(name.str().c_str(), std::ios::app);
+  }
+  for(uint32_t i=0;i<sourceApps.GetN();i++){
+	  Ptr<TcpWebClient> source1 = DynamicCast<TcpWebClient>(sourceApps.Get(i));
+	  std::vector<RequestDataStruct> responseTimes=source1->getResponseTimes();
+	  for(uint32_t j=0;j<responseTimes.size();j++){
+		  if(csv==""){
+			  std::cout << "Request Start Time," <<  responseTimes[j].requestStart << ",";
+			  std::cout << "Request Execution Time," << responseTimes[j].requestExecutionTime << std::endl;
+		  }
+		  else{
+			  fileOUT << responseTimes[j].requestStart << ",";
+			  fileOUT << responseTimes[j].requestExecutionTime << std::endl;
+		  }
+		  localCount++;
+		  localSum+=responseTimes[j].requestExecutionTime;
+		  localHash+=RecordHash(responseTimes[j].requestStart,responseTimes[j].requestExecutionTime);
+	  }
+  }
+  uint64_t count=localCount;
+  uint64_t hash=localHash;
+  double sum=localSum;
+#ifdef NS3_MPI
+  MPI_Reduce(&localCount,&count,1,MPI_UNSIGNED_LONG_LONG,MPI_SUM,0,MPI_COMM_WORLD);
+  MPI_Reduce(&localHash,&hash,1,MPI_UNSIGNED_LONG_LONG,MPI_SUM,0,MPI_COMM_WORLD);
+  MPI_Reduce(&localSum,&sum,1,MPI_DOUBLE,MPI_SUM,0,MPI_COMM_WORLD);
+#endif
+  int exitCode=0;
+  if(rank==0){
+	  std::ostringstream digest;
+	  digest << "records," << count << ",digest," << std::hex << hash;
+	  std::cerr << "ranks," << size << "," << digest.str() << ",meanResponseTime," << (count ? sum/count : 0.0) << std::endl;
+	  if(verify!=""){
+		  std::ifstream in(verify.c_str());
+		  std::string expected;
+		  if(!std::getline(in,expected)){
+			  std::ofstream out(verify.c_str());
+			  out << digest.str() << std::endl;
+			  std::cerr << "reference digest written to " << verify << std::endl;
+		  }
+		  else if(expected==digest.str()){
+			  std::cerr << "verify: results match the reference run" << std::endl;
+		  }
+		  else{
+			  std::cerr << "verify: MISMATCH, expected " << expected << std::endl;
+			  exitCode=1;
+		  }
+	  }
+  }
+  Simulator::Destroy();
+#ifdef NS3_MPI
+  MpiInterface::Disable ();
+#endif
+  return exitCode;
+}
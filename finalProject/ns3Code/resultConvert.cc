@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//Converts between the columnar binary result files (.wrb) and csv:
+//  --in=run.wrb                                  prints the configuration and the tables
+//  --in=run.wrb --table=responseTimes --out=run.csv [--columns=requestStart,responseTime] [--header=1]
+//  --in=run.csv --out=run.wrb [--table=responseTimes] [--columns=requestStart:time,responseTime:time]
+
+#include "ns3/core-module.h"
+#include "ns3/applications-module.h"
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("ResultConvert");
+
+static std::vector<std::string>
+Split (const std::string &s, char sep)
+{
+  std::vector<std::string> parts;
+  std::istringstream is(s);
+  std::string part;
+  while(std::getline(is,part,sep)){
+	  if(part!="")
+		  parts.push_back(part);
+  }
+  return parts;
+}
+
+static void
+PrintInfo (const WebResultReader &r)
+{
+  for(uint32_t i=0;i<r.GetNConfig();i++){
+	  std::cout << r.GetConfigKey(i) << "=" << r.GetConfigValue(i) << std::endl;
+  }
+  const char *typeNames[]={"uint64","int64","double","time"};
+  for(uint32_t t=0;t<r.GetNTables();t++){
+	  std::cout << "table " << r.GetTableName(t) << " rows " << r.GetNRows(t) << ":";
+	  for(uint32_t c=0;c<r.GetNColumns(t);c++){
+		  std::cout << " " << r.GetColumnName(t,c) << ":" << typeNames[r.GetColumnType(t,c)];
+	  }
+	  std::cout << std::endl;
+  }
+}
+
+static void
+ToCsv (const WebResultReader &r, const std::string &table, const std::string &columns, bool header, const std::string &out)
+{
+  int32_t t=r.FindTable(table);
+  if(t<0){
+	  NS_FATAL_ERROR("no table " << table);
+  }
+  std::vector<uint32_t> selected;
+  std::vector<std::string> names=Split(columns,',');
+  for(uint32_t i=0;i<names.size();i++){
+	  int32_t c=r.FindColumn(t,names[i]);
+	  if(c<0){
+		  NS_FATAL_ERROR("no column " << names[i] << " in table " << table);
+	  }
+	  selected.push_back(c);
+  }
+  if(names.empty()){
+	  for(uint32_t c=0;c<r.GetNColumns(t);c++)
+		  selected.push_back(c);
+  }
+  std::ofstream fileOUT(out.c_str());
+  fileOUT.precision(12);
+  if(header){
+	  for(uint32_t i=0;i<selected.size();i++)
+		  fileOUT << (i ? "," : "") << r.GetColumnName(t,selected[i]);
+	  fileOUT << std::endl;
+  }
+  for(uint32_t row=0;row<r.GetNRows(t);row++){
+	  for(uint32_t i=0;i<selected.size();i++){
+		  if(i)
+			  fileOUT << ",";
+		  switch(r.GetColumnType(t,selected[i])){
+		  case WebResultFile::UINT64:
+			  fileOUT << r.GetUint64(t,selected[i],row);
+			  break;
+		  case WebResultFile::INT64:
+			  fileOUT << r.GetInt64(t,selected[i],row);
+			  break;
+		  default:
+			  fileOUT << r.GetDouble(t,selected[i],row);
+		  }
+	  }
+	  fileOUT << std::endl;
+  }
+}
+
+static void
+FromCsv (const std::string &in, const std::string &table, const std::string &columns, const std::string &out)
+{
+  std::ifstream fileIN(in.c_str());
+  if(!fileIN.is_open()){
+	  NS_FATAL_ERROR("cannot open " << in);
+  }
+  WebResultWriter w;
+  if(!w.Open(out)){
+	  NS_FATAL_ERROR("cannot open " << out);
+  }
+  w.SetConfig("source",in);
+  uint32_t t=w.AddTable(table);
+  std::vector<WebResultFile::ColumnType> types;
+  std::vector<std::string> specs=Split(columns,',');
+  for(uint32_t i=0;i<specs.size();i++){
+	  std::vector<std::string> nameType=Split(specs[i],':');
+	  std::string type=(nameType.size()>1) ? nameType[1] : "double";
+	  if(type=="uint64")
+		  types.push_back(WebResultFile::UINT64);
+	  else if(type=="int64")
+		  types.push_back(WebResultFile::INT64);
+	  else if(type=="time")
+		  types.push_back(WebResultFile::TIME);
+	  else if(type=="double")
+		  types.push_back(WebResultFile::DOUBLE);
+	  else
+		  NS_FATAL_ERROR("unknown column type " << type);
+	  w.AddColumn(t,nameType[0],types.back());
+  }
+  std::string line;
+  uint64_t rows=0;
+  while(std::getline(fileIN,line)){
+	  std::vector<std::string> fields=Split(line,',');
+	  if(fields.size()!=types.size()){
+		  NS_FATAL_ERROR(in << ":" << rows+1 << " has " << fields.size() << " fields, expected " << types.size());
+	  }
+	  for(uint32_t i=0;i<types.size();i++){
+		  switch(types[i]){
+		  case WebResultFile::UINT64:
+			  w.AddUint64(t,i,strtoull(fields[i].c_str(),0,10));
+			  break;
+		  case WebResultFile::INT64:
+			  w.AddInt64(t,i,strtoll(fields[i].c_str(),0,10));
+			  break;
+		  case WebResultFile::TIME:
+			  w.AddTime(t,i,atof(fields[i].c_str()));
+			  break;
+		  default:
+			  w.AddDouble(t,i,atof(fields[i].c_str()));
+		  }
+	  }
+	  w.EndRow(t);
+	  rows++;
+  }
+  w.Close();
+  std::cerr << "converted," << rows << ",rows" << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string in="";
+  std::string out="";
+  std::string table="responseTimes";
+  std::string columns="";
+  bool header=false;
+  CommandLine cmd;
+  cmd.AddValue("in","Input file (.wrb or csv)",in);
+  cmd.AddValue("out","Output file (csv for a .wrb input, .wrb otherwise)",out);
+  cmd.AddValue("table","Table to convert",table);
+  cmd.AddValue("columns","Columns to write (.wrb input, default all) or name:type list of the csv columns "
+		  "(type uint64, int64, double or time; default the p4 csv requestStart:time,responseTime:time)",columns);
+  cmd.AddValue("header","Write the column names as first csv line",header);
+  cmd.Parse (argc,argv);
+
+  if(in==""){
+	  NS_FATAL_ERROR("--in is required");
+  }
+  if(in.size()>4 && in.compare(in.size()-4,4,".wrb")==0){
+	  WebResultReader r;
+	  if(!r.Open(in)){
+		  NS_FATAL_ERROR(in << " is not a complete result file");
+	  }
+	  if(out=="")
+		  PrintInfo(r);
+	  else
+		  ToCsv(r,table,columns,header,out);
+  }
+  else{
+	  if(out==""){
+		  NS_FATAL_ERROR("--out is required for a csv input");
+	  }
+	  FromCsv(in,table,columns=="" ? "requestStart:time,responseTime:time" : columns,out);
+  }
+  return 0;
+}
@@ -0,0 +1,214 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ProcessPool.h"
+
+#include <iostream>
+#include <deque>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+ProcessPool::ProcessPool (uint32_t workers, double timeout, uint32_t retries)
+  : m_workers (workers),
+    m_timeout (timeout),
+    m_retries (retries)
+{
+  if (m_workers == 0)
+    {
+      long cores = sysconf (_SC_NPROCESSORS_ONLN);
+      m_workers = cores > 0 ? (uint32_t)cores : 1;
+    }
+}
+
+void
+ProcessPool::SetEnvironment (const std::vector<std::string> &env)
+{
+  m_env = env;
+}
+
+uint32_t
+ProcessPool::GetWorkers (void) const
+{
+  return m_workers;
+}
+
+double
+ProcessPool::Now (void)
+{
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+void
+ProcessPool::MakeParentDirs (std::string fileName)
+{
+  for (std::string::size_type pos = fileName.find ('/', 1); pos != std::string::npos;
+       pos = fileName.find ('/', pos + 1))
+    {
+      mkdir (fileName.substr (0, pos).c_str (), 0755);
+    }
+}
+
+pid_t
+ProcessPool::Spawn (const SweepJob &job)
+{
+  if (job.ownsOutput && !job.output.empty ())
+    {
+      //runs append to their output, so a retry has to start from an empty file
+      std::remove (job.output.c_str ());
+    }
+  pid_t pid = fork ();
+  if (pid < 0)
+    {
+      std::perror ("fork");
+      std::exit (1);
+    }
+  if (pid == 0)
+    {
+      for (uint32_t i = 0; i < m_env.size (); i++)
+        {
+          putenv (const_cast<char *> (m_env[i].c_str ()));
+        }
+      if (!job.log.empty ())
+        {
+          int fd = open (job.log.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+          if (fd >= 0)
+            {
+              dup2 (fd, STDOUT_FILENO);
+              dup2 (fd, STDERR_FILENO);
+              close (fd);
+            }
+        }
+      std::vector<char *> argv;
+      for (uint32_t i = 0; i < job.argv.size (); i++)
+        {
+          argv.push_back (const_cast<char *> (job.argv[i].c_str ()));
+        }
+      argv.push_back (0);
+      execv (argv[0], &argv[0]);
+      std::fprintf (stderr, "execv %s: %s\n", argv[0], std::strerror (errno));
+      _exit (127);
+    }
+  return pid;
+}
+
+uint32_t
+ProcessPool::Run (const std::vector<SweepJob> &jobs, SweepListener *listener)
+{
+  //jobs waiting for a worker, with the attempt they are on
+  std::deque<std::pair<uint32_t, uint32_t> > pending;
+  for (uint32_t i = 0; i < jobs.size (); i++)
+    {
+      pending.push_back (std::make_pair (i, 1));
+    }
+  std::vector<Child> running;
+  uint32_t failures = 0;
+  while (!pending.empty () || !running.empty ())
+    {
+      while (running.size () < m_workers && !pending.empty ())
+        {
+          Child c;
+          c.job = pending.front ().first;
+          c.attempt = pending.front ().second;
+          pending.pop_front ();
+          c.start = Now ();
+          c.killed = false;
+          c.pid = Spawn (jobs[c.job]);
+          running.push_back (c);
+        }
+      int status;
+      struct rusage usage;
+      pid_t done = wait4 (-1, &status, WNOHANG, &usage);
+      if (done <= 0)
+        {
+          //nothing finished, enforce the timeouts and poll again
+          double now = Now ();
+          for (uint32_t i = 0; i < running.size (); i++)
+            {
+              if (m_timeout > 0 && !running[i].killed && now - running[i].start > m_timeout)
+                {
+                  kill (running[i].pid, SIGKILL);
+                  running[i].killed = true;
+                }
+            }
+          usleep (20000);
+          continue;
+        }
+      for (uint32_t i = 0; i < running.size (); i++)
+        {
+          if (running[i].pid != done)
+            {
+              continue;
+            }
+          Child c = running[i];
+          running.erase (running.begin () + i);
+          SweepResult r;
+          r.attempts = c.attempt;
+          r.wallSeconds = Now () - c.start;
+          r.maxRssKb = usage.ru_maxrss;
+          if (WIFEXITED (status))
+            {
+              r.exitCode = WEXITSTATUS (status);
+            }
+          else
+            {
+              r.exitCode = -WTERMSIG (status);
+            }
+          if (c.killed)
+            {
+              r.status = "timeout";
+            }
+          else
+            {
+              r.status = r.exitCode == 0 ? "ok" : "failed";
+            }
+          //a retry would append its rows after the partial ones of the failed attempt
+          bool retryable = jobs[c.job].ownsOutput || jobs[c.job].output.empty ();
+          if (r.status != "ok" && c.attempt <= m_retries && !retryable)
+            {
+              std::cerr << "run " << jobs[c.job].id << " " << r.status << " (exit " << r.exitCode
+                        << "), not retried: " << jobs[c.job].output << " is shared with other runs" << std::endl;
+            }
+          if (r.status != "ok" && c.attempt <= m_retries && retryable)
+            {
+              std::cerr << "run " << jobs[c.job].id << " " << r.status << " (exit " << r.exitCode
+                        << "), retrying" << std::endl;
+              pending.push_back (std::make_pair (c.job, c.attempt + 1));
+              break;
+            }
+          if (r.status != "ok")
+            {
+              failures++;
+            }
+          if (listener)
+            {
+              listener->JobFinished (jobs[c.job], r);
+            }
+          break;
+        }
+    }
+  return failures;
+}
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PROCESS_POOL_H
+#define PROCESS_POOL_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+//one run of the simulation binary
+typedef struct
+{
+  uint32_t id;
+  std::vector<std::string> argv; //argv[0] is the program
+  std::string output; //result file of the run ("" if none)
+  bool ownsOutput; //output is unique to this run and may be truncated before a retry
+  std::string log; //file receiving stdout/stderr ("" to inherit)
+} SweepJob;
+
+//what happened to a run
+typedef struct
+{
+  std::string status; //ok, failed or timeout
+  int exitCode; //exit status or -signal
+  uint32_t attempts;
+  double wallSeconds; //of the last attempt
+  long maxRssKb; //peak resident set size of the last attempt
+} SweepResult;
+
+/**
+ * Called by the pool every time a job reaches its final state
+ */
+class SweepListener
+{
+public:
+  virtual ~SweepListener () {}
+  virtual void JobFinished (const SweepJob &job, const SweepResult &result) = 0;
+};
+
+/**
+ * Runs jobs as child processes (fork/execv of the already built binary),
+ * keeping at most a fixed number of them alive at once.  Every attempt
+ * gets a wall-clock timeout; failed or timed out attempts are retried.
+ */
+class ProcessPool
+{
+public:
+  /**
+   * \param workers number of concurrent children (0 = number of online cores)
+   * \param timeout seconds before an attempt is killed (0 = no limit)
+   * \param retries extra attempts given to a failing job; jobs sharing their
+   * output with other jobs are never retried
+   */
+  ProcessPool (uint32_t workers, double timeout, uint32_t retries);
+
+  /**
+   * \param env NAME=value entries added to the environment of every child
+   */
+  void SetEnvironment (const std::vector<std::string> &env);
+
+  /**
+   * Run every job and block until all of them finished
+   * \return number of jobs that did not finish with status ok
+   */
+  uint32_t Run (const std::vector<SweepJob> &jobs, SweepListener *listener);
+
+  uint32_t GetWorkers (void) const;
+
+  //seconds since an arbitrary fixed point, used for timing runs
+  static double Now (void);
+
+  //creates the directories leading to a file (mkdir -p of its dirname)
+  static void MakeParentDirs (std::string fileName);
+
+private:
+  typedef struct
+  {
+    pid_t pid;
+    uint32_t job;
+    uint32_t attempt;
+    double start;
+    bool killed;
+  } Child;
+
+  pid_t Spawn (const SweepJob &job);
+
+  uint32_t m_workers;
+  double m_timeout;
+  uint32_t m_retries;
+  std::vector<std::string> m_env;
+};
+
+#endif /* PROCESS_POOL_H */
@@ -0,0 +1,504 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "RedSearch.h"
+#include "ns3/applications-module.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+
+using namespace ns3;
+
+namespace {
+
+//records the final state of every job of a batch
+class StatusCollector : public SweepListener
+{
+public:
+  virtual void JobFinished (const SweepJob &job, const SweepResult &result)
+  {
+    m_status[job.id] = result.status;
+  }
+  std::map<uint32_t, std::string> m_status;
+};
+
+//orders candidate indices by their evaluation, failed runs last
+class ByObjective
+{
+public:
+  ByObjective (const std::vector<double> &objective)
+    : m_objective (objective)
+  {
+  }
+  bool operator() (uint32_t a, uint32_t b) const
+  {
+    return m_objective[a] < m_objective[b];
+  }
+private:
+  const std::vector<double> &m_objective;
+};
+
+std::string
+ToString (double v)
+{
+  std::ostringstream os;
+  os << v;
+  return os.str ();
+}
+
+} // anonymous namespace
+
+RedSearch::RedSearch (const SweepSpec &spec, ProcessPool &pool)
+  : m_spec (spec),
+    m_pool (pool),
+    m_axes (spec.GetAxes ()),
+    m_rungs (spec.m_rungs),
+    m_runs (0)
+{
+  if (m_rungs.empty ())
+    {
+      //a single rung at the simTime of the fixed arguments (or p4's default)
+      m_rungs.push_back (0);
+    }
+}
+
+SweepSpec::Point
+RedSearch::ToPoint (const Choice &choice) const
+{
+  SweepSpec::Point point;
+  for (uint32_t a = 0; a < m_axes.size (); a++)
+    {
+      for (uint32_t n = 0; n < m_axes[a].names.size (); n++)
+        {
+          point.push_back (std::make_pair (m_axes[a].names[n], m_axes[a].values[choice[a]][n]));
+        }
+    }
+  return point;
+}
+
+bool
+RedSearch::IsValid (const Choice &choice) const
+{
+  std::map<std::string, double> v;
+  for (uint32_t i = 0; i < m_spec.m_fixedArgs.size (); i++)
+    {
+      v[m_spec.m_fixedArgs[i].first] = std::atof (m_spec.m_fixedArgs[i].second.c_str ());
+    }
+  SweepSpec::Point point = ToPoint (choice);
+  for (uint32_t i = 0; i < point.size (); i++)
+    {
+      v[point[i].first] = std::atof (point[i].second.c_str ());
+    }
+  if (v.count ("minTh") && v.count ("maxTh") && v["minTh"] >= v["maxTh"])
+    {
+      return false;
+    }
+  if (v.count ("maxTh") && v.count ("queueSize") && v["maxTh"] > v["queueSize"])
+    {
+      return false;
+    }
+  return true;
+}
+
+std::vector<std::string>
+RedSearch::Arguments (const Choice &choice, double simTime) const
+{
+  std::vector<std::string> argv;
+  argv.push_back (m_spec.m_program);
+  for (uint32_t a = 0; a < m_spec.m_fixedArgs.size (); a++)
+    {
+      argv.push_back ("--" + m_spec.m_fixedArgs[a].first + "=" + m_spec.m_fixedArgs[a].second);
+    }
+  SweepSpec::Point point = ToPoint (choice);
+  for (uint32_t a = 0; a < point.size (); a++)
+    {
+      if (point[a].first[0] != '_')
+        {
+          argv.push_back ("--" + point[a].first + "=" + point[a].second);
+        }
+    }
+  if (simTime > 0)
+    {
+      argv.push_back ("--simTime=" + ToString (simTime));
+    }
+  //only the summary is read back
+  argv.push_back ("--rawSamples=False");
+  if (m_spec.m_objective != "mean")
+    {
+      argv.push_back ("--percentiles=" + m_spec.m_objective);
+    }
+  return argv;
+}
+
+std::string
+RedSearch::Key (const std::vector<std::string> &argv) const
+{
+  std::string key;
+  for (uint32_t i = 0; i < argv.size (); i++)
+    {
+      key += (i ? " " : "") + argv[i];
+    }
+  return key;
+}
+
+void
+RedSearch::LoadCache (void)
+{
+  if (m_spec.m_cache == "")
+    {
+      return;
+    }
+  std::ifstream in (m_spec.m_cache.c_str ());
+  std::string line;
+  uint32_t loaded = 0;
+  while (std::getline (in, line))
+    {
+      //objective,ok,value,utilization,meanResponseTime,arguments
+      std::vector<std::string> fields;
+      std::string::size_type start = 0;
+      for (uint32_t i = 0; i < 5; i++)
+        {
+          std::string::size_type comma = line.find (',', start);
+          if (comma == std::string::npos)
+            {
+              break;
+            }
+          fields.push_back (line.substr (start, comma - start));
+          start = comma + 1;
+        }
+      if (fields.size () != 5 || fields[0] != m_spec.m_objective)
+        {
+          continue;
+        }
+      Evaluation e;
+      e.ok = fields[1] == "1";
+      e.objective = std::atof (fields[2].c_str ());
+      e.utilization = std::atof (fields[3].c_str ());
+      e.meanResponseTime = std::atof (fields[4].c_str ());
+      m_cache[line.substr (start)] = e;
+      loaded++;
+    }
+  if (loaded > 0)
+    {
+      std::cout << loaded << " cached evaluations in " << m_spec.m_cache << std::endl;
+    }
+}
+
+//column of a p4 result table, a file without it is not one this search can read
+static uint32_t
+Column (const WebResultReader &r, uint32_t table, const std::string &name, const std::string &output)
+{
+  int32_t column = r.FindColumn (table, name);
+  if (column < 0)
+    {
+      std::cerr << output << ": no column " << name << " in table " << r.GetTableName (table) << std::endl;
+      std::exit (1);
+    }
+  return column;
+}
+
+RedSearch::Evaluation
+RedSearch::Read (const std::string &output) const
+{
+  Evaluation e;
+  e.ok = false;
+  e.objective = std::numeric_limits<double>::infinity ();
+  e.utilization = 0;
+  e.meanResponseTime = 0;
+  WebResultReader r;
+  if (!r.Open (output))
+    {
+      return e;
+    }
+  int32_t summary = r.FindTable ("summary");
+  int32_t percentiles = r.FindTable ("percentiles");
+  if (summary < 0 || percentiles < 0 || r.GetNRows (summary) == 0)
+    {
+      return e;
+    }
+  e.meanResponseTime = r.GetDouble (summary, Column (r, summary, "meanResponseTime", output), 0);
+  double rate = std::atof (r.GetConfig ("bottleneckRate").c_str ()) * 1e6;
+  if (rate > 0)
+    {
+      e.utilization = r.GetDouble (summary, Column (r, summary, "throughputBps", output), 0) / rate;
+    }
+  if (m_spec.m_objective == "mean")
+    {
+      e.objective = e.meanResponseTime;
+      e.ok = true;
+      return e;
+    }
+  double q = std::atof (m_spec.m_objective.c_str ());
+  uint32_t scope = Column (r, percentiles, "scope", output);
+  uint32_t percentile = Column (r, percentiles, "percentile", output);
+  uint32_t value = Column (r, percentiles, "responseTime", output);
+  for (uint32_t row = 0; row < r.GetNRows (percentiles); row++)
+    {
+      //scope -1 is the histogram of every client
+      if (r.GetInt64 (percentiles, scope, row) == -1
+          && std::fabs (r.GetDouble (percentiles, percentile, row) - q) < 1e-9)
+        {
+          e.objective = r.GetDouble (percentiles, value, row);
+          e.ok = true;
+        }
+    }
+  return e;
+}
+
+std::vector<RedSearch::Evaluation>
+RedSearch::Evaluate (const std::vector<Choice> &choices, double simTime)
+{
+  std::vector<std::string> keys;
+  std::vector<SweepJob> jobs;
+  std::map<std::string, uint32_t> queued; //key -> job
+  for (uint32_t i = 0; i < choices.size (); i++)
+    {
+      std::vector<std::string> argv = Arguments (choices[i], simTime);
+      keys.push_back (Key (argv));
+      if (m_cache.count (keys.back ()) || queued.count (keys.back ()))
+        {
+          continue;
+        }
+      SweepJob job;
+      job.id = jobs.size ();
+      job.argv = argv;
+      SweepSpec::Point point = ToPoint (choices[i]);
+      job.output = SweepSpec::Substitute (m_spec.m_output != "" ? m_spec.m_output : "redSearch/eval{run}.wrb",
+                                          point, m_runs);
+      job.argv.push_back ("--out=" + job.output);
+      job.ownsOutput = true;
+      job.log = SweepSpec::Substitute (m_spec.m_log, point, m_runs);
+      ProcessPool::MakeParentDirs (job.output);
+      ProcessPool::MakeParentDirs (job.log);
+      m_runs++;
+      queued[keys.back ()] = jobs.size ();
+      jobs.push_back (job);
+    }
+  if (!jobs.empty ())
+    {
+      StatusCollector status;
+      m_pool.Run (jobs, &status);
+      std::ofstream cache;
+      if (m_spec.m_cache != "")
+        {
+          ProcessPool::MakeParentDirs (m_spec.m_cache);
+          cache.open (m_spec.m_cache.c_str (), std::ios::app);
+        }
+      for (std::map<std::string, uint32_t>::const_iterator it = queued.begin (); it != queued.end (); ++it)
+        {
+          const SweepJob &job = jobs[it->second];
+          Evaluation e = Read (job.output);
+          e.ok = e.ok && status.m_status[job.id] == "ok";
+          m_cache[it->first] = e;
+          if (cache.is_open ())
+            {
+              cache << m_spec.m_objective << "," << e.ok << "," << e.objective << "," << e.utilization << ","
+                    << e.meanResponseTime << "," << it->first << std::endl;
+            }
+        }
+    }
+  std::vector<Evaluation> evaluations;
+  for (uint32_t i = 0; i < keys.size (); i++)
+    {
+      evaluations.push_back (m_cache[keys[i]]);
+    }
+  return evaluations;
+}
+
+uint32_t
+RedSearch::Halve (const std::vector<Choice> &candidates)
+{
+  std::vector<uint32_t> alive;
+  for (uint32_t i = 0; i < candidates.size (); i++)
+    {
+      alive.push_back (i);
+    }
+  for (uint32_t r = 0; r < m_rungs.size (); r++)
+    {
+      std::vector<Choice> choices;
+      for (uint32_t i = 0; i < alive.size (); i++)
+        {
+          choices.push_back (candidates[alive[i]]);
+        }
+      std::vector<Evaluation> evaluations = Evaluate (choices, m_rungs[r]);
+      std::vector<double> objective (candidates.size (), std::numeric_limits<double>::infinity ());
+      for (uint32_t i = 0; i < alive.size (); i++)
+        {
+          if (evaluations[i].ok)
+            {
+              objective[alive[i]] = evaluations[i].objective;
+            }
+          if (r + 1 == m_rungs.size ())
+            {
+              m_final[candidates[alive[i]]] = evaluations[i];
+            }
+        }
+      std::stable_sort (alive.begin (), alive.end (), ByObjective (objective));
+      if (objective[alive[0]] == std::numeric_limits<double>::infinity ())
+        {
+          //every run of this rung failed
+          return candidates.size ();
+        }
+      if (r + 1 == m_rungs.size ())
+        {
+          return alive[0];
+        }
+      uint32_t keep = (uint32_t)std::ceil (m_spec.m_keep * alive.size ());
+      alive.resize (std::max (keep, 1u));
+    }
+  return candidates.size ();
+}
+
+void
+RedSearch::WritePareto (void) const
+{
+  std::vector<std::pair<Choice, Evaluation> > front;
+  for (std::map<Choice, Evaluation>::const_iterator a = m_final.begin (); a != m_final.end (); ++a)
+    {
+      if (!a->second.ok)
+        {
+          continue;
+        }
+      bool dominated = false;
+      for (std::map<Choice, Evaluation>::const_iterator b = m_final.begin (); b != m_final.end () && !dominated; ++b)
+        {
+          dominated = b->second.ok
+            && b->second.objective <= a->second.objective && b->second.utilization >= a->second.utilization
+            && (b->second.objective < a->second.objective || b->second.utilization > a->second.utilization);
+        }
+      if (!dominated)
+        {
+          front.push_back (*a);
+        }
+    }
+  std::ofstream file;
+  if (m_spec.m_pareto != "")
+    {
+      ProcessPool::MakeParentDirs (m_spec.m_pareto);
+      file.open (m_spec.m_pareto.c_str ());
+    }
+  std::ostream &os = file.is_open () ? file : std::cout;
+  for (uint32_t a = 0; a < m_axes.size (); a++)
+    {
+      for (uint32_t n = 0; n < m_axes[a].names.size (); n++)
+        {
+          os << m_axes[a].names[n] << ",";
+        }
+    }
+  os << "objective,utilization,meanResponseTime" << std::endl;
+  for (uint32_t i = 0; i < front.size (); i++)
+    {
+      SweepSpec::Point point = ToPoint (front[i].first);
+      for (uint32_t p = 0; p < point.size (); p++)
+        {
+          os << point[p].second << ",";
+        }
+      os << front[i].second.objective << "," << front[i].second.utilization << ","
+         << front[i].second.meanResponseTime << std::endl;
+    }
+  std::cout << front.size () << " pareto points of " << m_final.size () << " evaluated at the last rung" << std::endl;
+}
+
+int
+RedSearch::Run (void)
+{
+  LoadCache ();
+  //the middle of every axis, or the first valid point after it when the
+  //thresholds there do not fit (minTh < maxTh <= queueSize)
+  Choice current;
+  for (uint32_t a = 0; a < m_axes.size (); a++)
+    {
+      current.push_back (m_axes[a].values.size () / 2);
+    }
+  Choice start = current;
+  while (!IsValid (current))
+    {
+      uint32_t a = 0;
+      for (; a < m_axes.size (); a++)
+        {
+          current[a] = (current[a] + 1) % m_axes[a].values.size ();
+          if (current[a] != start[a])
+            {
+              break;
+            }
+        }
+      if (a == m_axes.size ())
+        {
+          std::cerr << "no point of the search space has minTh < maxTh <= queueSize" << std::endl;
+          return 1;
+        }
+    }
+  bool evaluated = false;
+  for (uint32_t round = 0; round < m_spec.m_rounds; round++)
+    {
+      bool changed = false;
+      for (uint32_t a = 0; a < m_axes.size (); a++)
+        {
+          std::vector<Choice> candidates;
+          for (uint32_t v = 0; v < m_axes[a].values.size (); v++)
+            {
+              Choice c = current;
+              c[a] = v;
+              if (IsValid (c))
+                {
+                  candidates.push_back (c);
+                }
+            }
+          if (candidates.empty () || (candidates.size () < 2 && evaluated))
+            {
+              continue;
+            }
+          uint32_t best = Halve (candidates);
+          if (best == candidates.size ())
+            {
+              std::cerr << "round " << round << ": no run of coordinate " << a << " succeeded" << std::endl;
+              continue;
+            }
+          evaluated = true;
+          changed = changed || candidates[best][a] != current[a];
+          current = candidates[best];
+          const Evaluation &e = m_final[current];
+          std::cout << "round " << round << " axis " << a << ":";
+          for (uint32_t n = 0; n < m_axes[a].names.size (); n++)
+            {
+              std::cout << " " << m_axes[a].names[n] << "=" << m_axes[a].values[current[a]][n];
+            }
+          std::cout << " objective " << e.objective << " utilization " << e.utilization
+                    << " (" << m_runs << " runs so far)" << std::endl;
+        }
+      if (!changed)
+        {
+          break;
+        }
+    }
+  if (!evaluated)
+    {
+      return 1;
+    }
+  std::cout << "best:";
+  SweepSpec::Point point = ToPoint (current);
+  for (uint32_t p = 0; p < point.size (); p++)
+    {
+      std::cout << " --" << point[p].first << "=" << point[p].second;
+    }
+  std::cout << " objective " << m_final[current].objective << std::endl;
+  WritePareto ();
+  return 0;
+}
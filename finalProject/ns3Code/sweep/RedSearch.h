@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RED_SEARCH_H
+#define RED_SEARCH_H
+
+#include "SweepSpec.h"
+#include "ProcessPool.h"
+
+#include <map>
+
+/**
+ * Coordinate search of the RED parameters of a sweep spec (sweep --mode=red).
+ *
+ * Every axis of the spec is one coordinate with its values in order.  The
+ * search starts at the middle value of every axis; for one coordinate at a
+ * time all its values are tried with the others fixed and the best one is
+ * kept, for a number of rounds or until a round changes nothing.  The values
+ * of a coordinate are compared by successive halving: all of them run for
+ * the first rung's simTime, the best keep fraction continues with the next
+ * rung's simTime and so on, so poor settings only cost a short run.
+ * Points with minTh >= maxTh or maxTh > queueSize are skipped.
+ *
+ * The runs go through the ProcessPool with --out=<output>, and the objective
+ * (a response time percentile or the mean) and the bottleneck utilization are
+ * read from the result file.  Every evaluation is appended to the cache file
+ * and read back by later searches, and the points evaluated at the last rung
+ * that no other point beats in both objective and utilization are written
+ * to the pareto file.
+ */
+class RedSearch
+{
+public:
+  RedSearch (const SweepSpec &spec, ProcessPool &pool);
+
+  /**
+   * Run the search, printing every accepted step
+   * \return 0, or 1 if no point could be evaluated
+   */
+  int Run (void);
+
+private:
+  //index into each axis' values
+  typedef std::vector<uint32_t> Choice;
+
+  typedef struct
+  {
+    bool ok;
+    double objective; //seconds
+    double utilization; //bottleneck throughput / rate
+    double meanResponseTime;
+  } Evaluation;
+
+  //runs the choices not in the cache for simTime seconds, returns them in order
+  std::vector<Evaluation> Evaluate (const std::vector<Choice> &choices, double simTime);
+  //successive halving over the candidates, returns the index of the winner
+  uint32_t Halve (const std::vector<Choice> &candidates);
+  Evaluation Read (const std::string &output) const;
+  bool IsValid (const Choice &choice) const;
+  SweepSpec::Point ToPoint (const Choice &choice) const;
+  std::vector<std::string> Arguments (const Choice &choice, double simTime) const;
+  std::string Key (const std::vector<std::string> &argv) const;
+  void LoadCache (void);
+  void WritePareto (void) const;
+
+  const SweepSpec &m_spec;
+  ProcessPool &m_pool;
+  std::vector<SweepSpec::Axis> m_axes;
+  std::vector<double> m_rungs;
+  std::map<std::string, Evaluation> m_cache; //by argument string
+  std::map<Choice, Evaluation> m_final; //evaluated at the last rung
+  uint32_t m_runs;
+};
+
+#endif /* RED_SEARCH_H */
@@ -0,0 +1,281 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "SweepSpec.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+
+namespace {
+
+std::string
+Trim (const std::string &s)
+{
+  std::string::size_type b = s.find_first_not_of (" \t\r");
+  if (b == std::string::npos)
+    {
+      return "";
+    }
+  std::string::size_type e = s.find_last_not_of (" \t\r");
+  return s.substr (b, e - b + 1);
+}
+
+std::vector<std::string>
+Split (const std::string &s, char sep)
+{
+  std::vector<std::string> out;
+  std::string cur;
+  std::istringstream in (s);
+  while (std::getline (in, cur, sep))
+    {
+      out.push_back (Trim (cur));
+    }
+  return out;
+}
+
+std::vector<std::string>
+Words (const std::string &s)
+{
+  std::vector<std::string> out;
+  std::istringstream in (s);
+  std::string w;
+  while (in >> w)
+    {
+      out.push_back (w);
+    }
+  return out;
+}
+
+void
+SpecError (const std::string &file, uint32_t line, const std::string &msg)
+{
+  std::cerr << file << ":" << line << ": " << msg << std::endl;
+  std::exit (1);
+}
+
+} // anonymous namespace
+
+SweepSpec::SweepSpec ()
+  : m_workers (0),
+    m_timeout (0),
+    m_retries (0),
+    m_outputArg ("csv"),
+    m_objective ("90"),
+    m_keep (0.5),
+    m_rounds (3)
+{
+}
+
+void
+SweepSpec::Load (std::string fileName)
+{
+  std::ifstream in (fileName.c_str ());
+  if (!in)
+    {
+      std::cerr << "cannot open sweep spec " << fileName << std::endl;
+      std::exit (1);
+    }
+  std::string line;
+  uint32_t lineNo = 0;
+  while (std::getline (in, line))
+    {
+      lineNo++;
+      std::string::size_type hash = line.find ('#');
+      if (hash != std::string::npos)
+        {
+          line = line.substr (0, hash);
+        }
+      line = Trim (line);
+      if (line.empty ())
+        {
+          continue;
+        }
+      std::string::size_type eq = line.find ('=');
+      if (eq == std::string::npos)
+        {
+          SpecError (fileName, lineNo, "expected 'key = value'");
+        }
+      std::vector<std::string> key = Words (line.substr (0, eq));
+      std::string value = Trim (line.substr (eq + 1));
+      if (key.size () == 1)
+        {
+          if (key[0] == "program")
+            {
+              m_program = value;
+            }
+          else if (key[0] == "workers")
+            {
+              m_workers = std::atoi (value.c_str ());
+            }
+          else if (key[0] == "timeout")
+            {
+              m_timeout = std::atof (value.c_str ());
+            }
+          else if (key[0] == "retries")
+            {
+              m_retries = std::atoi (value.c_str ());
+            }
+          else if (key[0] == "manifest")
+            {
+              m_manifest = value;
+            }
+          else if (key[0] == "output")
+            {
+              m_output = value;
+            }
+          else if (key[0] == "outputArg")
+            {
+              m_outputArg = value;
+            }
+          else if (key[0] == "log")
+            {
+              m_log = value;
+            }
+          else if (key[0] == "objective")
+            {
+              m_objective = value;
+            }
+          else if (key[0] == "rungs")
+            {
+              std::vector<std::string> rungs = Words (value);
+              m_rungs.clear ();
+              for (uint32_t i = 0; i < rungs.size (); i++)
+                {
+                  m_rungs.push_back (std::atof (rungs[i].c_str ()));
+                }
+            }
+          else if (key[0] == "keep")
+            {
+              m_keep = std::atof (value.c_str ());
+              if (m_keep <= 0 || m_keep > 1)
+                {
+                  SpecError (fileName, lineNo, "keep must be in (0,1]");
+                }
+            }
+          else if (key[0] == "rounds")
+            {
+              m_rounds = std::atoi (value.c_str ());
+            }
+          else if (key[0] == "cache")
+            {
+              m_cache = value;
+            }
+          else if (key[0] == "pareto")
+            {
+              m_pareto = value;
+            }
+          else
+            {
+              SpecError (fileName, lineNo, "unknown setting '" + key[0] + "'");
+            }
+        }
+      else if (key.size () == 2 && key[0] == "env")
+        {
+          m_env.push_back (key[1] + "=" + value);
+        }
+      else if (key.size () == 2 && key[0] == "arg")
+        {
+          m_fixedArgs.push_back (std::make_pair (key[1], value));
+        }
+      else if (key.size () == 2 && (key[0] == "param" || key[0] == "zip"))
+        {
+          Axis axis;
+          axis.names = Split (key[1], ',');
+          std::vector<std::string> steps = Words (value);
+          if (steps.empty ())
+            {
+              SpecError (fileName, lineNo, "axis '" + key[1] + "' has no values");
+            }
+          for (uint32_t i = 0; i < steps.size (); i++)
+            {
+              std::vector<std::string> v;
+              if (key[0] == "zip")
+                {
+                  v = Split (steps[i], ',');
+                }
+              else
+                {
+                  v.push_back (steps[i]);
+                }
+              if (v.size () != axis.names.size ())
+                {
+                  SpecError (fileName, lineNo, "'" + steps[i] + "' does not match '" + key[1] + "'");
+                }
+              axis.values.push_back (v);
+            }
+          m_axes.push_back (axis);
+        }
+      else
+        {
+          SpecError (fileName, lineNo, "cannot parse '" + line + "'");
+        }
+    }
+  if (m_program.empty ())
+    {
+      SpecError (fileName, lineNo, "no program given");
+    }
+}
+
+const std::vector<SweepSpec::Axis> &
+SweepSpec::GetAxes (void) const
+{
+  return m_axes;
+}
+
+std::vector<SweepSpec::Point>
+SweepSpec::Expand (void) const
+{
+  std::vector<Point> points (1);
+  for (uint32_t a = 0; a < m_axes.size (); a++)
+    {
+      std::vector<Point> next;
+      for (uint32_t p = 0; p < points.size (); p++)
+        {
+          for (uint32_t s = 0; s < m_axes[a].values.size (); s++)
+            {
+              Point point = points[p];
+              for (uint32_t n = 0; n < m_axes[a].names.size (); n++)
+                {
+                  point.push_back (std::make_pair (m_axes[a].names[n], m_axes[a].values[s][n]));
+                }
+              next.push_back (point);
+            }
+        }
+      points = next;
+    }
+  return points;
+}
+
+std::string
+SweepSpec::Substitute (std::string templ, const Point &point, uint32_t run)
+{
+  std::ostringstream runStr;
+  runStr << run;
+  Point all = point;
+  all.push_back (std::make_pair (std::string ("run"), runStr.str ()));
+  for (uint32_t i = 0; i < all.size (); i++)
+    {
+      std::string key = "{" + all[i].first + "}";
+      std::string::size_type pos;
+      while ((pos = templ.find (key)) != std::string::npos)
+        {
+          templ.replace (pos, key.size (), all[i].second);
+        }
+    }
+  return templ;
+}
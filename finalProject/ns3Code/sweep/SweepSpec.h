@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SWEEP_SPEC_H
+#define SWEEP_SPEC_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+
+/**
+ * Sweep specification read from a plain text file.
+ *
+ * One setting per line, '#' starts a comment:
+ *
+ *   program = build/scratch/p4            binary that is run for every point
+ *   env LD_LIBRARY_PATH = build           extra environment for the runs
+ *   workers = 0                           concurrent runs (0 = number of cores)
+ *   timeout = 3600                        seconds per attempt (0 = none)
+ *   retries = 1                           extra attempts after a failure
+ *                                         (not for runs sharing an output)
+ *   manifest = p4/manifest.csv            one line per finished run
+ *   output = p4/FIFO_load{_load}_queue{_queue}.csv
+ *   outputArg = csv                       output is passed as --csv=<output>
+ *   log = p4/logs/run{run}.log            stdout/stderr of every run
+ *   arg verbose = False                   fixed argument for every run
+ *   param isDropTail = True False         cartesian axis
+ *   zip _load,nFlows = 80,320 90,458      several names moving together
+ *
+ * Names starting with '_' are labels: they are only substituted into the
+ * output/log templates and never passed to the program.
+ *
+ * sweep --mode=red searches the axes instead of running their product (see
+ * RedSearch.h); each axis is one coordinate and these settings apply:
+ *
+ *   objective = 90                        response time percentile to minimise (or mean)
+ *   rungs = 100 200 400                   simTime of the successive halving rungs
+ *   keep = 0.5                            fraction of the candidates promoted to the next rung
+ *   rounds = 3                            passes over all coordinates
+ *   cache = red/cache.csv                 evaluated points, reused by later searches
+ *   pareto = red/pareto.csv               non-dominated response time/utilization points
+ */
+class SweepSpec
+{
+public:
+  SweepSpec ();
+
+  /**
+   * Parse a spec file, exits with a message on malformed lines
+   * \param fileName path of the spec
+   */
+  void Load (std::string fileName);
+
+  //one point of the sweep (name -> value, in axis order)
+  typedef std::vector<std::pair<std::string, std::string> > Point;
+
+  /**
+   * \return every point of the cartesian product of the axes
+   */
+  std::vector<Point> Expand (void) const;
+
+  /**
+   * Replace {name} (and {run}) in a template with the values of a point
+   */
+  static std::string Substitute (std::string templ, const Point &point, uint32_t run);
+
+  std::string m_program;
+  std::vector<std::string> m_env; //NAME=value entries
+  uint32_t m_workers;
+  double m_timeout;
+  uint32_t m_retries;
+  std::string m_manifest;
+  std::string m_output;
+  std::string m_outputArg;
+  std::string m_log;
+  std::vector<std::pair<std::string, std::string> > m_fixedArgs;
+  //search mode settings
+  std::string m_objective;
+  std::vector<double> m_rungs;
+  double m_keep;
+  uint32_t m_rounds;
+  std::string m_cache;
+  std::string m_pareto;
+
+  //an axis is a list of names and, for each step, one value per name
+  typedef struct
+  {
+    std::vector<std::string> names;
+    std::vector<std::vector<std::string> > values;
+  } Axis;
+
+  const std::vector<Axis> &GetAxes (void) const;
+
+private:
+  std::vector<Axis> m_axes;
+};
+
+#endif /* SWEEP_SPEC_H */
@@ -0,0 +1,19 @@
+# Port of prj3/graphs/runP3Experiments.py (96 runs).
+# Run from the ns-3 root after ./waf build:
+#   ./waf --run "scratch/sweep --spec=scratch/sweep/specs/p3Loc.spec"
+program = build/scratch/p3Loc
+env LD_LIBRARY_PATH = build
+timeout = 3600
+# the runs share p3Loc.csv, a retry would add its rows after the partial ones
+retries = 0
+manifest = p3Loc.manifest.csv
+log = p3Loc-logs/run{run}.log
+# every run appends its line to the same csv, as the python script did
+output = p3Loc.csv
+outputArg = csv
+arg gridLength = 1000
+arg verbose = 0
+param txPower = 10 100 500
+param isAODV = 0 1
+param trafficIntensity = 0.1 0.25 0.5 0.9
+param numNodes = 2 4 16 256
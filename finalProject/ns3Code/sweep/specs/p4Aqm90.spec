@@ -0,0 +1,22 @@
+# Bottleneck AQM comparison at 90% load: response time CDFs of FIFO, RED
+# and CoDel on the bottleneck link only (--aqm), 120 packet (180000 byte)
+# buffer, RED thresholds of 30/90 packets in bytes.
+program = build/scratch/p4
+env LD_LIBRARY_PATH = build
+timeout = 14400
+retries = 1
+manifest = p4/aqm.manifest.csv
+log = p4/logs/AQM_{_aqm}_load{_load}.log
+output = p4/AQM_{_aqm}_load{_load}.cdf.csv
+outputArg = cdf
+arg nNodes = 7
+arg bottleneckRate = 10
+arg receiverWindowSize = 30000
+arg linkDelays = .005
+arg queueSize = 180000
+arg minTh = 45000
+arg maxTh = 135000
+arg rawSamples = False
+arg warmup = 200
+zip _load,nFlows = 90,458
+zip _aqm,aqm = fifo,droptail red,red codel,codel
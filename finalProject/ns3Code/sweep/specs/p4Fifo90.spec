@@ -0,0 +1,18 @@
+# FIFO queue-length sweep at 90% load (Figure 9b of makeCDFs.py).
+# Load is set as in the Readme: 7 nodes with 458 browsers each; queue
+# lengths are in 1500 byte packets and passed to p4 in bytes.
+program = build/scratch/p4
+env LD_LIBRARY_PATH = build
+timeout = 14400
+retries = 1
+manifest = p4/manifest.csv
+log = p4/logs/FIFO_load{_load}_queue{_queue}.log
+output = p4/FIFO_load{_load}_queue{_queue}.csv
+outputArg = csv
+arg isDropTail = True
+arg nNodes = 7
+arg bottleneckRate = 10
+arg receiverWindowSize = 30000
+arg linkDelays = .005
+zip _load,nFlows = 90,458
+zip _queue,queueSize = 30,45000 60,90000 120,180000 190,285000 240,360000
@@ -0,0 +1,29 @@
+# RED parameter search at 90% load (sweep --mode=red): minimise the p90
+# response time over queue weight, max drop probability, thresholds and
+# buffer. Candidates of a coordinate run 150 s, the better half 300 s and
+# the best quarter 600 s; every run lands in the cache, so a second search
+# (or one with more values) only runs the new points.
+program = build/scratch/p4
+env LD_LIBRARY_PATH = build
+timeout = 7200
+retries = 1
+objective = 90
+rungs = 150 300 600
+keep = 0.5
+rounds = 3
+cache = p4/red/cache.csv
+pareto = p4/red/pareto.csv
+output = p4/red/eval{run}.wrb
+log = p4/red/logs/eval{run}.log
+arg nNodes = 7
+arg bottleneckRate = 10
+arg receiverWindowSize = 30000
+arg linkDelays = .005
+arg isDropTail = False
+arg warmup = 100
+arg nFlows = 458
+param weightFactor = 0.0005 0.001 0.002 0.004 0.008
+param maxDropProb = 5 10 20 50
+param minTh = 15000 30000 45000 60000
+param maxTh = 45000 90000 135000 180000
+param queueSize = 90000 180000 270000
@@ -0,0 +1,23 @@
+# Scalability ladder: the p4 dumbbell with 300, 1k, 5k and 20k browsers
+# (10 client nodes), the bottleneck scaled with the population to keep the
+# load near 90%. A browser offers about 2.8 kbps (7 nodes of 458 browsers
+# load 10 Mbps to 90%), so the rungs sit at 84, 94, 88 and 91%; the
+# bottleneck rate is whole Mbps, 1 Mbps needs at least 300 browsers.
+# One run at a time so the timings do not disturb each other; every run
+# appends its line to the profile csv.
+# python graphs/plotScaling.py p4/scale/profile.csv
+program = build/scratch/p4
+env LD_LIBRARY_PATH = build
+workers = 1
+timeout = 86400
+manifest = p4/scale/manifest.csv
+log = p4/scale/logs/browsers{_browsers}.log
+output = p4/scale/profile.csv
+outputArg = profile
+arg nNodes = 10
+arg receiverWindowSize = 30000
+arg linkDelays = .005
+arg simTime = 100
+arg warmup = 20
+arg rawSamples = False
+zip _browsers,nFlows,bottleneckRate = 300,30,1 1000,100,3 5000,500,16 20000,2000,62
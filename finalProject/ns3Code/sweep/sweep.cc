@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Parallel experiment sweep driver. Expands a sweep spec (see SweepSpec.h)
+ * into one run per parameter point and runs them directly on the built
+ * scenario binary (no waf in the loop) across a pool of worker processes.
+ * Every finished run is recorded in the manifest.  With --mode=red the
+ * axes are searched instead (see RedSearch.h).
+ */
+#include "ns3/core-module.h"
+#include "SweepSpec.h"
+#include "ProcessPool.h"
+#include "RedSearch.h"
+
+#include <fstream>
+#include <iostream>
+#include <set>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WebSweep");
+
+//appends one csv line per finished run to the manifest
+class ManifestWriter : public SweepListener
+{
+public:
+  ManifestWriter (std::string fileName)
+  {
+    if (fileName != "")
+      {
+        bool exists = std::ifstream (fileName.c_str ()).good ();
+        m_file.open (fileName.c_str (), std::ios::app);
+        if (!exists)
+          {
+            m_file << "run,status,exitCode,attempts,wallSeconds,maxRssKb,output,args" << std::endl;
+          }
+      }
+  }
+  virtual void JobFinished (const SweepJob &job, const SweepResult &result)
+  {
+    std::cout << "run " << job.id << " " << result.status << " in " << result.wallSeconds << "s" << std::endl;
+    if (!m_file.is_open ())
+      {
+        return;
+      }
+    m_file << job.id << "," << result.status << "," << result.exitCode << "," << result.attempts << ","
+           << result.wallSeconds << "," << result.maxRssKb << "," << job.output << ",";
+    for (uint32_t i = 1; i < job.argv.size (); i++)
+      {
+        m_file << (i > 1 ? " " : "") << job.argv[i];
+      }
+    m_file << std::endl;
+  }
+private:
+  std::ofstream m_file;
+};
+
+int
+main (int argc, char *argv[])
+{
+  std::string specFile = "";
+  uint32_t workers = 0;
+  bool dryRun = false;
+  std::string mode = "grid";
+  CommandLine cmd;
+  cmd.AddValue ("spec", "Sweep specification file", specFile);
+  cmd.AddValue ("workers", "Concurrent runs, overrides the spec (0 = keep spec/number of cores)", workers);
+  cmd.AddValue ("dryRun", "Only print the commands that would be run", dryRun);
+  cmd.AddValue ("mode", "grid runs every point of the spec, red searches its axes for the best objective", mode);
+  cmd.Parse (argc, argv);
+
+  if (specFile == "")
+    {
+      std::cerr << "usage: sweep --spec=<file> [--workers=N] [--dryRun=True] [--mode=grid|red]" << std::endl;
+      return 1;
+    }
+  SweepSpec spec;
+  spec.Load (specFile);
+  if (workers != 0)
+    {
+      spec.m_workers = workers;
+    }
+  if (mode == "red")
+    {
+      ProcessPool pool (spec.m_workers, spec.m_timeout, spec.m_retries);
+      pool.SetEnvironment (spec.m_env);
+      RedSearch search (spec, pool);
+      return search.Run ();
+    }
+  if (mode != "grid")
+    {
+      std::cerr << "unknown mode " << mode << std::endl;
+      return 1;
+    }
+
+  std::vector<SweepSpec::Point> points = spec.Expand ();
+  std::vector<SweepJob> jobs;
+  std::multiset<std::string> outputs;
+  for (uint32_t i = 0; i < points.size (); i++)
+    {
+      SweepJob job;
+      job.id = i;
+      job.argv.push_back (spec.m_program);
+      for (uint32_t a = 0; a < spec.m_fixedArgs.size (); a++)
+        {
+          job.argv.push_back ("--" + spec.m_fixedArgs[a].first + "=" + spec.m_fixedArgs[a].second);
+        }
+      for (uint32_t a = 0; a < points[i].size (); a++)
+        {
+          if (points[i][a].first[0] != '_')
+            {
+              job.argv.push_back ("--" + points[i][a].first + "=" + points[i][a].second);
+            }
+        }
+      job.output = SweepSpec::Substitute (spec.m_output, points[i], i);
+      if (job.output != "")
+        {
+          job.argv.push_back ("--" + spec.m_outputArg + "=" + job.output);
+        }
+      job.log = SweepSpec::Substitute (spec.m_log, points[i], i);
+      outputs.insert (job.output);
+      jobs.push_back (job);
+    }
+  //only outputs written by a single run are cleared before a retry
+  for (uint32_t i = 0; i < jobs.size (); i++)
+    {
+      jobs[i].ownsOutput = outputs.count (jobs[i].output) == 1;
+    }
+
+  ProcessPool pool (spec.m_workers, spec.m_timeout, spec.m_retries);
+  pool.SetEnvironment (spec.m_env);
+  std::cout << jobs.size () << " runs on " << pool.GetWorkers () << " workers" << std::endl;
+  if (dryRun)
+    {
+      for (uint32_t i = 0; i < jobs.size (); i++)
+        {
+          for (uint32_t a = 0; a < jobs[i].argv.size (); a++)
+            {
+              std::cout << (a ? " " : "") << jobs[i].argv[a];
+            }
+          std::cout << std::endl;
+        }
+      return 0;
+    }
+  ProcessPool::MakeParentDirs (spec.m_manifest);
+  for (uint32_t i = 0; i < jobs.size (); i++)
+    {
+      ProcessPool::MakeParentDirs (jobs[i].output);
+      ProcessPool::MakeParentDirs (jobs[i].log);
+    }
+  ManifestWriter manifest (spec.m_manifest);
+  double start = ProcessPool::Now ();
+  uint32_t failures = pool.Run (jobs, &manifest);
+  std::cout << "sweep finished in " << ProcessPool::Now () - start << "s, "
+            << failures << " of " << jobs.size () << " runs failed" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,351 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//Microbenchmarks of the web model hot paths, printed as csv (case,variant,iterations,nsPerOp,allocsPerOp):
+//  sample   EmpiricalRandomVariable::GetValue over each table of http-distributions.h
+//  request  TcpWebClient::CreateRequest, the request Send builds, for a few request sizes
+//  parse    TcpWebServer::AddRequestData of one 3000 byte request arriving in various segment splits
+//  lookup   TcpWebServer::FindConnection with N accepted connections (socket state lookup of HandleRead)
+//  object   WebObjectCatalog::Sample, the Zipf draw of a request's object, for a few catalog sizes
+//  queue    a WebQueueRecorder on a CoDelQueue of 1 and 2 packets, overfilled and dequeued late enough for
+//           CoDel to drop at the head; aborts if the recorded occupancy goes below zero or misses the queue
+//./waf --run "scratch/webBench [--iterations=100000] [--case=parse] [--connections=1,10,100,1000,10000]"
+//Allocations are the calls of operator new (Packet buffers, Ptr objects, vectors...) during the timed loop.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/http-distributions.h"
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <new>
+#include <algorithm>
+#include <cstdlib>
+#include <time.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WebBench");
+
+//every operator new of the program (and of the ns-3 libraries) goes through these
+static uint64_t g_allocations=0;
+
+#if __cplusplus >= 201103L
+#define BENCH_THROW_BAD_ALLOC
+#define BENCH_NOTHROW noexcept
+#else
+#define BENCH_THROW_BAD_ALLOC throw (std::bad_alloc)
+#define BENCH_NOTHROW throw ()
+#endif
+
+void *
+operator new (std::size_t size) BENCH_THROW_BAD_ALLOC
+{
+  g_allocations++;
+  void *p=std::malloc(size ? size : 1);
+  if(!p){
+	  throw std::bad_alloc();
+  }
+  return p;
+}
+
+void *
+operator new[] (std::size_t size) BENCH_THROW_BAD_ALLOC
+{
+  return operator new (size);
+}
+
+void
+operator delete (void *p) BENCH_NOTHROW
+{
+  std::free(p);
+}
+
+void
+operator delete[] (void *p) BENCH_NOTHROW
+{
+  std::free(p);
+}
+
+//keeps the compiler from dropping the benchmarked calls
+static volatile uint64_t g_sink=0;
+
+static double
+Now (void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return ts.tv_sec*1e9+ts.tv_nsec;
+}
+
+//times iterations calls of op(i) after a short warm up
+template <typename Op>
+static void
+Measure (std::string name, std::string variant, uint32_t iterations, Op &op)
+{
+  for(uint32_t i=0;i<iterations/10;i++){
+	  op(i);
+  }
+  uint64_t allocations=g_allocations;
+  double start=Now();
+  for(uint32_t i=0;i<iterations;i++){
+	  op(i);
+  }
+  double ns=Now()-start;
+  allocations=g_allocations-allocations;
+  std::cout << name << "," << variant << "," << iterations << "," << ns/iterations << ","
+		  << (double)allocations/iterations << std::endl;
+}
+
+static Ptr<EmpiricalRandomVariable>
+Table (const httpDist::intd_t *table, uint32_t n)
+{
+  Ptr<EmpiricalRandomVariable> v=CreateObject<EmpiricalRandomVariable>();
+  for(uint32_t i=0;i<n;i++){
+	  v->CDF(table[i].i,table[i].d);
+  }
+  return v;
+}
+
+static Ptr<EmpiricalRandomVariable>
+Table (const httpDist::dd_t *table, uint32_t n)
+{
+  Ptr<EmpiricalRandomVariable> v=CreateObject<EmpiricalRandomVariable>();
+  for(uint32_t i=0;i<n;i++){
+	  v->CDF(table[i].d1,table[i].d2);
+  }
+  return v;
+}
+
+#define TABLE(name,type) Table(httpDist::name,sizeof(httpDist::name)/sizeof(httpDist::type))
+
+struct SampleOp
+{
+  Ptr<EmpiricalRandomVariable> v;
+  void operator() (uint32_t i){
+	  g_sink+=(uint64_t)v->GetValue();
+  }
+};
+
+struct RequestOp
+{
+  uint32_t requestSize;
+  void operator() (uint32_t i){
+	  g_sink+=TcpWebClient::CreateRequest(requestSize,1000+(i&0xff))->GetSize();
+  }
+};
+
+//one request through a fresh connection: accept, every segment, done
+struct ParseOp
+{
+  Ptr<TcpWebServer> server;
+  Ptr<Socket> socket;
+  std::vector<Ptr<Packet> > segments;
+  void operator() (uint32_t i){
+	  server->AddConnection(socket);
+	  uint32_t responseSize=0;
+	  for(uint32_t s=0;s<segments.size();s++){
+		  if(server->AddRequestData(0,segments[s],responseSize)){
+			  break;
+		  }
+	  }
+	  NS_ABORT_MSG_IF(responseSize!=4321,"request parsed as response size " << responseSize);
+	  server->RemoveConnection(0);
+	  g_sink+=responseSize;
+  }
+};
+
+struct ObjectOp
+{
+  Ptr<WebObjectCatalog> catalog;
+  Ptr<UniformRandomVariable> uniform;
+  void operator() (uint32_t i){
+	  g_sink+=catalog->Sample(uniform);
+  }
+};
+
+static void
+Tick (void)
+{
+}
+
+//one round through the queue: three arrivals (the full queue drops the rest), dequeued 20ms later
+struct QueueOp
+{
+  Ptr<Queue> queue;
+  Ptr<WebQueueRecorder> recorder;
+  void operator() (uint32_t i){
+	  for(uint32_t p=0;p<3;p++){
+		  queue->Enqueue(Create<Packet>(1000));
+	  }
+	  Simulator::Schedule(MilliSeconds(20),&Tick);
+	  Simulator::Run();
+	  for(Ptr<Packet> p=queue->Dequeue();p;p=queue->Dequeue()){
+		  g_sink+=p->GetSize();
+	  }
+	  NS_ABORT_MSG_IF(recorder->GetPackets()!=0 || recorder->GetBytes()!=0,"empty queue recorded as "
+			  << recorder->GetPackets() << " packets, " << recorder->GetBytes() << " bytes");
+  }
+};
+
+struct LookupOp
+{
+  Ptr<TcpWebServer> server;
+  std::vector<Ptr<Socket> > sockets;
+  void operator() (uint32_t i){
+	  g_sink+=server->FindConnection(sockets[i%sockets.size()]);
+  }
+};
+
+static std::vector<uint32_t>
+ParseList (std::string s)
+{
+  std::vector<uint32_t> values;
+  std::istringstream is(s);
+  std::string v;
+  while(std::getline(is,v,',')){
+	  if(v!="")
+		  values.push_back(atoi(v.c_str()));
+  }
+  return values;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t iterations=100000;
+  std::string only="";
+  std::string connections="1,10,100,1000,10000";
+  CommandLine cmd;
+  cmd.AddValue("iterations","timed calls per benchmark",iterations);
+  cmd.AddValue("case","run only sample, request, parse, lookup, object or queue",only);
+  cmd.AddValue("connections","comma separated numbers of accepted connections for lookup",connections);
+  cmd.Parse(argc,argv);
+  if(only!="" && only!="sample" && only!="request" && only!="parse" && only!="lookup" && only!="object" && only!="queue"){
+	  NS_FATAL_ERROR("unknown case " << only);
+  }
+
+  std::cout << "case,variant,iterations,nsPerOp,allocsPerOp" << std::endl;
+
+  if(only=="" || only=="sample"){
+	  const char *names[]={"primaryRequest","secondaryRequest","primaryReply","secondaryReply",
+			  "filesPerPage","consecutivePages","thinkTime"};
+	  Ptr<EmpiricalRandomVariable> tables[]={TABLE(primaryRequest,intd_t),TABLE(secondaryRequest,intd_t),
+			  TABLE(primaryReply,intd_t),TABLE(secondaryReply,intd_t),TABLE(filesPerPage,intd_t),
+			  TABLE(consecutivePages,intd_t),TABLE(thinkTime,dd_t)};
+	  for(uint32_t t=0;t<7;t++){
+		  SampleOp op;
+		  op.v=tables[t];
+		  Measure("sample",names[t],iterations,op);
+	  }
+  }
+
+  if(only=="" || only=="request"){
+	  uint32_t sizes[]={8,400,1460,16384};
+	  for(uint32_t s=0;s<4;s++){
+		  RequestOp op;
+		  op.requestSize=sizes[s];
+		  std::ostringstream variant;
+		  variant << sizes[s] << "B";
+		  Measure("request",variant.str(),iterations,op);
+	  }
+  }
+
+  //a node with a stack only to get real sockets to tell the connections apart
+  Ptr<Node> node=CreateObject<Node>();
+  InternetStackHelper stack;
+  stack.Install(node);
+
+  if(only=="" || only=="parse"){
+	  //first segment sizes of each split, the rest in segments of the last size;
+	  //the request is larger than one mss so that mss1460 is not whole
+	  const uint32_t requestSize=3000;
+	  const char *names[]={"whole","header3+rest","header7+rest","mss1460","mss536","mss100"};
+	  uint32_t first[]={requestSize,3,7,1460,536,100};
+	  uint32_t rest[]={requestSize,requestSize,requestSize,1460,536,100};
+	  Ptr<Packet> request=TcpWebClient::CreateRequest(requestSize,4321);
+	  for(uint32_t v=0;v<sizeof(first)/sizeof(first[0]);v++){
+		  ParseOp op;
+		  op.server=CreateObject<TcpWebServer>();
+		  op.socket=Socket::CreateSocket(node,TcpSocketFactory::GetTypeId());
+		  uint32_t offset=0;
+		  uint32_t size=first[v];
+		  while(offset<request->GetSize()){
+			  size=std::min(size,request->GetSize()-offset);
+			  op.segments.push_back(request->CreateFragment(offset,size));
+			  offset+=size;
+			  size=rest[v];
+		  }
+		  std::ostringstream variant;
+		  variant << names[v] << "/" << op.segments.size() << "segments";
+		  Measure("parse",variant.str(),iterations,op);
+	  }
+  }
+
+  if(only=="" || only=="lookup"){
+	  std::vector<uint32_t> counts=ParseList(connections);
+	  for(uint32_t c=0;c<counts.size();c++){
+		  NS_ABORT_MSG_IF(counts[c]==0,"lookup needs at least one connection");
+		  LookupOp op;
+		  op.server=CreateObject<TcpWebServer>();
+		  for(uint32_t i=0;i<counts[c];i++){
+			  op.sockets.push_back(Socket::CreateSocket(node,TcpSocketFactory::GetTypeId()));
+			  op.server->AddConnection(op.sockets.back());
+		  }
+		  std::ostringstream variant;
+		  variant << counts[c] << "connections";
+		  Measure("lookup",variant.str(),iterations,op);
+	  }
+  }
+
+  if(only=="" || only=="object"){
+	  uint32_t sizes[]={1000,1000000,10000000};
+	  for(uint32_t s=0;s<3;s++){
+		  ObjectOp op;
+		  op.catalog=CreateObject<WebObjectCatalog>();
+		  op.catalog->Build(sizes[s],0.8,1);
+		  op.uniform=CreateObject<UniformRandomVariable>();
+		  std::ostringstream variant;
+		  variant << sizes[s] << "objects";
+		  Measure("object",variant.str(),iterations,op);
+	  }
+  }
+
+  if(only=="" || only=="queue"){
+	  uint32_t limits[]={1,2};
+	  for(uint32_t l=0;l<2;l++){
+		  QueueOp op;
+		  op.queue=CreateObject<CoDelQueue>();
+		  op.queue->SetAttribute("Mode",StringValue("QUEUE_MODE_PACKETS"));
+		  op.queue->SetAttribute("MaxPackets",UintegerValue(limits[l]));
+		  //drop at the head even when only one packet is left
+		  op.queue->SetAttribute("MinBytes",UintegerValue(0));
+		  op.recorder=CreateObject<WebQueueRecorder>();
+		  op.recorder->Attach(op.queue);
+		  std::ostringstream variant;
+		  variant << "codel" << limits[l] << "packets";
+		  Measure("queue",variant.str(),iterations,op);
+		  NS_ABORT_MSG_IF(op.recorder->GetEarlyDrops()==0 || op.recorder->GetForcedDrops()==0,
+				  "queue " << variant.str() << " did not see both head and arrival drops");
+	  }
+  }
+
+  Simulator::Destroy();
+  return 0;
+}
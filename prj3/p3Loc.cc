@@ -29,6 +29,15 @@
 #include <sstream>
 #include <cmath>
 
+//--out needs the WebResultWriter of finalProject's applications module; a stock ns-3.24.1
+//applications module (only onoff-application swapped) builds without it and rejects --out
+#if defined(__has_include)
+#if __has_include("ns3/WebResultFile.h")
+#include "ns3/WebResultFile.h"
+#define P3_RESULT_FILE
+#endif
+#endif
+
 #define END_TIME 3.0
 
 using namespace ns3;
@@ -52,6 +61,62 @@ Vector GetPosition (Ptr<Node> node)
 }
 }
 
+//writes the run parameters, the bytes of every flow and the efficiency to a columnar binary file (WebResultFile)
+static void
+WriteBinaryResults (std::string outFile, std::string program, double gridLength, int numNodes, double txPower,
+		bool isAODV, double trafficIntensity, ApplicationContainer &sourceApps, ApplicationContainer &sinkApps)
+{
+#ifndef P3_RESULT_FILE
+  NS_FATAL_ERROR("--out needs the WebResultFile.h of finalProject/ns3Code/applications (see README.md)");
+#else
+  WebResultWriter w;
+  if(!w.Open(outFile)){
+	  NS_FATAL_ERROR("cannot open " << outFile);
+  }
+  w.SetConfig("program",program);
+  w.SetConfig("gridLength",patch::to_string(gridLength));
+  w.SetConfig("numNodes",patch::to_string(numNodes));
+  w.SetConfig("txPower",patch::to_string(txPower));
+  w.SetConfig("isAODV",patch::to_string(isAODV));
+  w.SetConfig("trafficIntensity",patch::to_string(trafficIntensity));
+  uint32_t flows=w.AddTable("flows");
+  w.AddColumn(flows,"flow",WebResultFile::UINT64);
+  w.AddColumn(flows,"bytesSent",WebResultFile::UINT64);
+  w.AddColumn(flows,"bytesReceived",WebResultFile::UINT64);
+  w.AddColumn(flows,"srcX",WebResultFile::DOUBLE);
+  w.AddColumn(flows,"srcY",WebResultFile::DOUBLE);
+  w.AddColumn(flows,"sinkX",WebResultFile::DOUBLE);
+  w.AddColumn(flows,"sinkY",WebResultFile::DOUBLE);
+  uint64_t totalBytesSent=0;
+  uint64_t totalBytesReceived=0;
+  for(uint32_t i=0;i<sinkApps.GetN();i++){
+	  uint32_t receivedBytes=DynamicCast<PacketSink>(sinkApps.Get(i))->GetTotalRx();
+	  uint32_t bytesSent=DynamicCast<OnOffApplication>(sourceApps.Get(i))->getTotalBytesSent();
+	  w.AddUint64(flows,0,i);
+	  w.AddUint64(flows,1,bytesSent);
+	  w.AddUint64(flows,2,receivedBytes);
+	  Vector sourceLocation=helpFunc::GetPosition(sourceApps.Get(i)->GetNode());
+	  Vector sinkLocation=helpFunc::GetPosition(sinkApps.Get(i)->GetNode());
+	  w.AddDouble(flows,3,sourceLocation.x);
+	  w.AddDouble(flows,4,sourceLocation.y);
+	  w.AddDouble(flows,5,sinkLocation.x);
+	  w.AddDouble(flows,6,sinkLocation.y);
+	  w.EndRow(flows);
+	  totalBytesSent+=bytesSent;
+	  totalBytesReceived+=receivedBytes;
+  }
+  uint32_t summary=w.AddTable("summary");
+  w.AddColumn(summary,"bytesSent",WebResultFile::UINT64);
+  w.AddColumn(summary,"bytesReceived",WebResultFile::UINT64);
+  w.AddColumn(summary,"netEfficiency",WebResultFile::DOUBLE);
+  w.AddUint64(summary,0,totalBytesSent);
+  w.AddUint64(summary,1,totalBytesReceived);
+  w.AddDouble(summary,2,totalBytesSent ? (double)totalBytesReceived/totalBytesSent*100.0 : 0.0);
+  w.EndRow(summary);
+  w.Close();
+#endif
+}
+
 
 int 
 main (int argc, char *argv[])
@@ -68,6 +133,7 @@ main (int argc, char *argv[])
   std::string phyMode ("DsssRate11Mbps");
   //double rss = -80;  // -dBm
   std::string csvFile="";
+  std::string outFile="";
   CommandLine cmd;
   cmd.AddValue ("gridLength", "Grid Length in meters (gridLength by gridLength grid)", gridLength);
   cmd.AddValue ("numNodes", "Number of wireless Nodes", numNodes);
@@ -75,6 +141,7 @@ main (int argc, char *argv[])
   cmd.AddValue("isAODV","Boolean to toggle between AODV and OSLR Routing Protocols (True=AODV)",isAODV);
   cmd.AddValue("trafficIntensity","Trafic intensity on all the nodes",trafficIntensity);
   cmd.AddValue("csv","csv File Name",csvFile);
+  cmd.AddValue("out","Binary result file (.wrb): parameters, bytes of every flow and efficiency",outFile);
   cmd.AddValue("verbose","turn on debugging",verbose);
   cmd.Parse (argc,argv);
 
@@ -278,6 +345,9 @@ main (int argc, char *argv[])
 		  fileOUT << sinkLocation << std::endl;
 	  }
   }
+  if(outFile!=""){
+	  WriteBinaryResults(outFile,"p3Loc",gridLength,numNodes,txPowerPrint,isAODV,trafficIntensity,sourceApps,sinkApps);
+  }
   Simulator::Destroy();
   return 0;
 }